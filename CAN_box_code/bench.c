@@ -0,0 +1,339 @@
+
+#include "datatypes.h"
+#include "lpc21xx.h"
+#include "can.h"
+#include "can_user.h"
+#include "router.h"
+#include "timer.h"
+#include "hardware.h"
+#include "crc_data.h"
+#include "bench.h"
+
+
+// identifier is needed by PCANFlash.exe -> do not delete
+const b8_t Ident[] __attribute__ ((used)) = { "PCAN-Router"};
+
+
+// info data for PCANFlash.exe
+const crc_array_t  C2F_Array __attribute__((section(".C2F_Info"), used)) = {
+
+	.Str = CRC_IDENT_STRING,
+	.Version = 0x21,
+	.Day = 5,
+	.Month = 5,
+	.Year = 6,
+	.Mode = 1,
+
+	// crc infos are patched during link time by flash.ld
+	// crc value is patched by PCANFlash.exe
+};
+
+
+//
+// Cycle count benchmark of the hot path primitives, built by make bench
+// as bench_can.hex in place of main.c. CAN1 and CAN2 must be connected
+// with a terminated cable: test messages sent on CAN1 are received on
+// CAN2.
+//
+// Timer1 runs at PCLK, every test is timed BENCH_SAMPLES times for each
+// MAM setting of BENCH_Mam[]. The results go out on CAN1 with BENCH_ID,
+// see bench.h, and the run repeats every second. host/bench_decode
+// prints them from a candump log or a PCAN-View trace.
+//
+
+
+// MAM settings, MAMCR and MAMTIM. 3 cycles is the fastest flash timing
+// at 60 MHz, the last one is the setting of crt0.S.
+static const u8_t  BENCH_Mam[][2] = {
+
+	{ 0, 3},
+	{ 1, 3},
+	{ 2, 4},
+	{ 2, 3},
+};
+
+#define  BENCH_MAM_COUNT		( sizeof ( BENCH_Mam) / sizeof ( BENCH_Mam[0]))
+
+
+// a test: Setup runs before every sample, Op is timed
+typedef struct {
+
+	void			(*Setup) ( void);
+	void			(*Op) ( void);
+} BENCH_Test_t;
+
+
+static CANMsg_t  BENCH_Msg;
+static CANMsg_t  BENCH_Copy;
+
+// samples of the running test
+static u32_t  BENCH_Min, BENCH_Max, BENCH_Sum;
+
+
+
+// BENCH_Wait()
+// busy wait for Cycles PCLK cycles
+static void  BENCH_Wait ( u32_t  Cycles)
+{
+	u32_t  start = T1TC;
+	
+	
+	while ( ( u32_t) T1TC - start < Cycles)
+	{
+		CAN_UserTxTask();
+	}
+}
+
+
+
+
+// BENCH_Quiet()
+// wait until the busses are idle and empty both Rx queues
+static void  BENCH_Quiet ( void)
+{
+	CANMsg_t  msg;
+	
+	
+	// a message at 500 kbit/s takes less than 270 us
+	BENCH_Wait ( TIMER_PCLK / 1000);
+	
+	while ( CAN_UserRead ( CAN_BUS1, &msg) == CAN_ERR_OK  ||  CAN_UserRead ( CAN_BUS2, &msg) == CAN_ERR_OK)
+	{
+	}
+}
+
+
+
+
+// BENCH_Loopback()
+// send the test message on CAN1 and wait for it on CAN2
+static void  BENCH_Loopback ( void)
+{
+	u32_t  start;
+	
+	
+	BENCH_Quiet();
+	
+	CAN_UserWrite ( CAN_BUS1, &BENCH_Msg, CAN_USER_NO_DEADLINE);
+	
+	start = T1TC;
+	
+	while ( CAN_UserPeek ( CAN_BUS2) == NULL  &&  ( u32_t) T1TC - start < TIMER_PCLK / 100)
+	{
+	}
+}
+
+
+
+
+//
+// tests
+//
+
+
+static void  BENCH_OpNone ( void)
+{
+}
+
+
+static void  BENCH_OpPoll ( void)
+{
+	CAN_UserPeek ( CAN_BUS2);
+}
+
+
+static void  BENCH_OpRead ( void)
+{
+	CAN_UserRead ( CAN_BUS2, &BENCH_Copy);
+}
+
+
+static void  BENCH_OpWrite ( void)
+{
+	CAN_UserWrite ( CAN_BUS1, &BENCH_Msg, CAN_USER_NO_DEADLINE);
+}
+
+
+static void  BENCH_OpCopy ( void)
+{
+	CAN_UserCopy ( &BENCH_Copy, &BENCH_Msg);
+}
+
+
+static void  BENCH_OpLED ( void)
+{
+	HW_SetLED ( HW_LED_CAN1, HW_LED_ORANGE);
+}
+
+
+static void  BENCH_OpForward ( void)
+{
+	CANRxMsg_t  *pMsg;
+	u32_t  lock;
+	
+	
+	pMsg = CAN_UserPeek ( CAN_BUS2);
+	
+	if ( pMsg != NULL)
+	{
+		lock = CAN_UserLock();
+		ROUTE_Process ( CAN_BUS2, pMsg);
+		CAN_UserUnlock ( lock);
+		
+		CAN_UserRelease ( CAN_BUS2);
+	}
+}
+
+
+static const BENCH_Test_t  BENCH_Tests[BENCH_T_COUNT] = {
+
+	[BENCH_T_EMPTY]	= { BENCH_OpNone, BENCH_OpNone},
+	[BENCH_T_POLL]		= { BENCH_Quiet, BENCH_OpPoll},
+	[BENCH_T_READ]		= { BENCH_Loopback, BENCH_OpRead},
+	[BENCH_T_WRITE]	= { BENCH_Quiet, BENCH_OpWrite},
+	[BENCH_T_COPY]		= { BENCH_OpNone, BENCH_OpCopy},
+	[BENCH_T_LED]		= { BENCH_OpNone, BENCH_OpLED},
+	[BENCH_T_FORWARD]	= { BENCH_Loopback, BENCH_OpForward},
+};
+
+
+
+
+// BENCH_Run()
+// time a test BENCH_SAMPLES times
+static void  BENCH_Run ( const BENCH_Test_t  *pTest)
+{
+	u32_t  n, t0, t1;
+	
+	
+	BENCH_Min = 0xFFFFFFFF;
+	BENCH_Max = 0;
+	BENCH_Sum = 0;
+	
+	for ( n = 0; n < BENCH_SAMPLES; n++)
+	{
+		pTest->Setup();
+		
+		t0 = T1TC;
+		pTest->Op();
+		t1 = T1TC;
+		
+		t1 -= t0;
+		
+		BENCH_Min  = t1 < BENCH_Min ? t1 : BENCH_Min;
+		BENCH_Max  = t1 > BENCH_Max ? t1 : BENCH_Max;
+		BENCH_Sum += t1;
+	}
+}
+
+
+
+
+// BENCH_Put16()
+// store a cycle count less the timing overhead, saturated to 16 bit
+static void  BENCH_Put16 ( u8_t  *pData, u32_t  Cycles, u32_t  Overhead)
+{
+	Cycles = Cycles > Overhead ? Cycles - Overhead : 0;
+	Cycles = Cycles > 0xFFFF ? 0xFFFF : Cycles;
+	
+	pData[0] = Cycles;
+	pData[1] = Cycles >> 8;
+}
+
+
+
+
+// BENCH_Send()
+// send a result message, one at a time so the Tx queue never fills
+static void  BENCH_Send ( u32_t  Test, u32_t  Cfg, u32_t  Overhead)
+{
+	CANMsg_t  msg;
+	
+	
+	msg.Id   = BENCH_ID;
+	msg.Type = CAN_MSG_STANDARD;
+	msg.Len  = 8;
+	
+	msg.Data8[0] = Test;
+	msg.Data8[1] = Cfg;
+	
+	BENCH_Put16 ( &msg.Data8[2], BENCH_Min, Overhead);
+	BENCH_Put16 ( &msg.Data8[4], BENCH_Sum / BENCH_SAMPLES, Overhead);
+	BENCH_Put16 ( &msg.Data8[6], BENCH_Max, Overhead);
+	
+	CAN_UserWrite ( CAN_BUS1, &msg, CAN_USER_NO_DEADLINE);
+	BENCH_Quiet();
+}
+
+
+
+
+// main()
+// entry point from crt0.S
+int  main ( void)
+{
+	u32_t  m, t, cfg, overhead;
+	
+	
+	// init hardware
+	HW_Init();
+	
+	TIMER_Init();
+	
+	if ( !ROUTE_Init())
+	{
+		// unsorted routing table, see main.c
+		HW_SetLED ( HW_LED_STATUS, HW_LED_RED);
+		
+		while ( 1);
+	}
+	
+	CAN_UserInit();
+	
+	// Timer1 at PCLK instead of 1 us
+	T1TCR = 2;
+	T1PR  = 0;
+	T1TCR = 1;
+	
+	BENCH_Msg.Id   = BENCH_MSG_ID;
+	BENCH_Msg.Type = CAN_MSG_STANDARD;
+	BENCH_Msg.Len  = 8;
+	BENCH_Msg.Data32[0] = 0x67452301;
+	BENCH_Msg.Data32[1] = 0xEFCDAB89;
+	
+	HW_SetLED ( HW_LED_CAN1, HW_LED_GREEN);
+	HW_SetLED ( HW_LED_CAN2, HW_LED_GREEN);
+	
+	while ( 1)
+	{
+		for ( m = 0; m < BENCH_MAM_COUNT; m++)
+		{
+			// MAMTIM may only change with the MAM off
+			MAMCR  = 0;
+			MAMTIM = BENCH_Mam[m][1];
+			MAMCR  = BENCH_Mam[m][0];
+			
+			cfg = BENCH_Mam[m][0] | BENCH_Mam[m][1] << 2;
+#ifdef __thumb__
+			cfg |= BENCH_CFG_THUMB;
+#endif
+			
+			// the overhead is measured for every setting
+			BENCH_Run ( &BENCH_Tests[BENCH_T_EMPTY]);
+			overhead = BENCH_Min;
+			
+			BENCH_Send ( BENCH_T_EMPTY, cfg, 0);
+			
+			for ( t = BENCH_T_EMPTY + 1; t < BENCH_T_COUNT; t++)
+			{
+				BENCH_Run ( &BENCH_Tests[t]);
+				BENCH_Send ( t, cfg, overhead);
+			}
+		}
+		
+		BENCH_Min = BENCH_Max = BENCH_Sum = 0;
+		BENCH_Send ( BENCH_END, BENCH_END, 0);
+		
+		BENCH_Wait ( TIMER_PCLK);
+	}
+}
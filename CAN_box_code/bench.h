@@ -0,0 +1,46 @@
+
+#ifndef  _BENCH_H_
+#define  _BENCH_H_
+
+
+// Result Id of the cycle count benchmark, see bench.c
+#ifndef  BENCH_ID
+#define  BENCH_ID				0x7F2
+#endif
+
+// Id of the test messages
+#define  BENCH_MSG_ID			0x123
+
+// samples per test and configuration
+#define  BENCH_SAMPLES			32
+
+
+// Tests, byte 0 of a result message
+enum {
+	BENCH_T_EMPTY = 0,						// timing overhead, not subtracted
+	BENCH_T_POLL,								// CAN_UserPeek() on an empty Rx queue
+	BENCH_T_READ,								// CAN_UserRead() of a queued message
+	BENCH_T_WRITE,								// CAN_UserWrite() with a free transmit buffer
+	BENCH_T_COPY,								// CAN_UserCopy(), the Data32 copy
+	BENCH_T_LED,								// HW_SetLED()
+	BENCH_T_FORWARD,							// Rx -> Tx forward as in main_Drain()
+	BENCH_T_COUNT
+};
+
+#define  BENCH_END				0xFF		// test of the last message of a run
+
+
+// Result message, one per test and configuration
+//	byte 0		test, BENCH_T_...
+//	byte 1		configuration, see BENCH_CFG_...
+//	byte 2..3	minimum
+//	byte 4..5	mean
+//	byte 6..7	maximum
+// All in PCLK cycles less the BENCH_T_EMPTY minimum, little endian and
+// saturated at 0xFFFF.
+#define  BENCH_CFG_MAMCR(cfg)		( ( cfg) & 3)
+#define  BENCH_CFG_MAMTIM(cfg)	( ( ( cfg) >> 2) & 7)
+#define  BENCH_CFG_THUMB			0x80		// built with -mthumb
+
+
+#endif
@@ -0,0 +1,193 @@
+
+#include "datatypes.h"
+#include "lpc21xx.h"
+#include "can.h"
+#include "can_user.h"
+#include "busoff.h"
+#include "stats.h"
+#include "sched.h"
+
+
+// Command register: abort the pending transmissions of all buffers
+#define  CAN_CMR_AT				( 1 << 1)
+#define  CAN_CMR_STB_ALL		( 7 << 5)
+#define  CAN_SR_TBS_ALL			( 1 << 2 | 1 << 10 | 1 << 18)
+
+#define  BUSOFF_GSR(hBus)		( ( hBus) == CAN_BUS1 ? C1GSR : C2GSR)
+
+
+volatile u8_t  BUSOFF_State[2];
+
+
+typedef struct {
+
+	u32_t			DownTick;					// SCHED_Tick of the first bus off of an outage
+	u32_t			OffTick;						// SCHED_Tick of the bus off
+	u32_t			OnTick;						// SCHED_Tick of the last bus on
+	u32_t			BackoffMs;
+} BUSOFF_Bus_t;
+
+static BUSOFF_Bus_t  BUSOFF_Bus[2];
+
+
+
+// BUSOFF_TxError()
+// Tx error callback, on interrupt level. The controller is in reset mode
+// after a bus off and stays there until BUSOFF_Task() sets it on. A bus
+// off during the recovery starts it over.
+static u32_t  BUSOFF_TxError ( CANHandle_t  hBus)
+{
+	BUSOFF_Bus_t  *pB;
+	
+	
+	pB = &BUSOFF_Bus[hBus];
+	
+	if ( BUSOFF_State[hBus] == BUSOFF_OFF  ||  !( BUSOFF_GSR ( hBus) & CAN_GSR_BS))
+	{
+		return 0;
+	}
+	
+	pB->OffTick = SCHED_Tick;
+	
+	// a bus off during the recovery continues the outage
+	if ( BUSOFF_State[hBus] == BUSOFF_ON)
+	{
+		pB->DownTick = pB->OffTick;
+	}
+	
+	// flapping bus, back off longer
+	if ( pB->OffTick - pB->OnTick < BUSOFF_STABLE_MS)
+	{
+		pB->BackoffMs = pB->BackoffMs * 2 < BUSOFF_MAX_MS ? pB->BackoffMs * 2 : BUSOFF_MAX_MS;
+	}
+	
+	else
+	{
+		pB->BackoffMs = BUSOFF_MIN_MS;
+	}
+	
+	BUSOFF_State[hBus] = BUSOFF_OFF;
+	
+	return 0;
+}
+
+
+
+
+// Tx error callbacks for CAN1 and CAN2
+u32_t  BUSOFF_TxErrorCAN1 ( void)
+{
+	return BUSOFF_TxError ( CAN_BUS1);
+}
+
+
+u32_t  BUSOFF_TxErrorCAN2 ( void)
+{
+	return BUSOFF_TxError ( CAN_BUS2);
+}
+
+
+
+
+// BUSOFF_Update()
+// advance the recovery of a bus
+static void  BUSOFF_Update ( CANHandle_t  hBus)
+{
+	BUSOFF_Bus_t  *pB;
+	u32_t  now, n, sr, lock;
+	
+	
+	pB  = &BUSOFF_Bus[hBus];
+	now = SCHED_Tick;
+	
+	switch ( BUSOFF_State[hBus])
+	{
+		case BUSOFF_OFF:
+			if ( now - pB->OffTick < pB->BackoffMs)
+			{
+				break;
+			}
+			
+			// everything queued for the bus is stale by now. Empty the
+			// queues first, so the aborted buffers aren't loaded again,
+			// then abort the buffers while the controller is still in
+			// reset mode.
+			lock = CAN_UserLock();
+			
+			n = CAN_UserTxPurge ( hBus);
+			
+			if ( hBus == CAN_BUS1)
+			{
+				sr    = C1SR;
+				C1CMR = CAN_CMR_AT | CAN_CMR_STB_ALL;
+			}
+			
+			else
+			{
+				sr    = C2SR;
+				C2CMR = CAN_CMR_AT | CAN_CMR_STB_ALL;
+			}
+			
+			CAN_UserUnlock ( lock);
+			
+			for ( sr = ~sr & CAN_SR_TBS_ALL; sr != 0; sr &= sr - 1)
+			{
+				n++;
+			}
+			
+			STAT_Bus[hBus].Purged += n;
+			
+			// the controller waits for 128 * 11 recessive bits before
+			// it sends
+			pB->OnTick = now;
+			BUSOFF_State[hBus] = BUSOFF_RECOVER;
+			
+			CAN_SetBusMode ( hBus, BUS_ON);
+			break;
+		
+		case BUSOFF_RECOVER:
+			if ( BUSOFF_GSR ( hBus) & CAN_GSR_BS)
+			{
+				break;
+			}
+			
+			n = now - pB->DownTick;
+			
+			STAT_Bus[hBus].OffMs += n;
+			STAT_Hwm ( &STAT_Bus[hBus].OffMaxMs, n);
+			
+			BUSOFF_State[hBus] = BUSOFF_ON;
+			break;
+		
+		default:
+			break;
+	}
+}
+
+
+
+
+// BUSOFF_Task()
+// scheduled every tick
+static void  BUSOFF_Task ( void)
+{
+	BUSOFF_Update ( CAN_BUS1);
+	BUSOFF_Update ( CAN_BUS2);
+}
+
+
+
+
+// BUSOFF_Init()
+// register the recovery task. Called before CAN_UserInit() sets the
+// callbacks, a bus off right at the start finds the backoff set up.
+void  BUSOFF_Init ( void)
+{
+	BUSOFF_Bus[CAN_BUS1].BackoffMs = BUSOFF_MIN_MS;
+	BUSOFF_Bus[CAN_BUS2].BackoffMs = BUSOFF_MIN_MS;
+	
+	BUSOFF_Bus[CAN_BUS1].OnTick = SCHED_Tick - BUSOFF_STABLE_MS;
+	BUSOFF_Bus[CAN_BUS2].OnTick = SCHED_Tick - BUSOFF_STABLE_MS;
+	
+	SCHED_Add ( BUSOFF_Task, 1, 1, 10);
+}
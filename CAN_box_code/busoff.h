@@ -0,0 +1,60 @@
+
+#ifndef  _BUSOFF_H_
+#define  _BUSOFF_H_
+
+
+// Bus off recovery. The controller enters reset mode on bus off and the
+// Tx error callback takes it from there instead of the automatic bus on
+// of the library. BUSOFF_Task() waits for a backoff time, purges the
+// messages staged and queued in the library meanwhile and aborts the
+// transmit buffers, then sets the bus on. The backoff doubles for a bus which goes off again within
+// BUSOFF_STABLE_MS of its last bus on. Forwarding to a bus which is off
+// is dropped, the values would be stale when it comes back.
+
+
+// backoff limits
+#ifndef  BUSOFF_MIN_MS
+#define  BUSOFF_MIN_MS			10
+#endif
+
+#ifndef  BUSOFF_MAX_MS
+#define  BUSOFF_MAX_MS			1000
+#endif
+
+// time on the bus after which the backoff starts over
+#ifndef  BUSOFF_STABLE_MS
+#define  BUSOFF_STABLE_MS		1000
+#endif
+
+
+// states
+#define  BUSOFF_ON				0			// bus on
+#define  BUSOFF_OFF				1			// bus off, waiting for the backoff
+#define  BUSOFF_RECOVER			2			// bus on requested, 128 * 11 recessive bits to go
+
+
+// state per bus, written by the Tx error callback and BUSOFF_Task()
+extern volatile u8_t  BUSOFF_State[2];
+
+
+
+// BUSOFF_IsOff()
+// returns non zero while hBus is off or recovering
+static inline u32_t  BUSOFF_IsOff ( CANHandle_t  hBus)
+{
+	return BUSOFF_State[hBus];
+}
+
+
+// busoff function protos
+
+u32_t  BUSOFF_TxErrorCAN1 ( void);
+
+
+u32_t  BUSOFF_TxErrorCAN2 ( void);
+
+
+void  BUSOFF_Init ( void);
+
+
+#endif
@@ -1,167 +1,974 @@
-
-#include "datatypes.h"
-#include "lpc21xx.h"
-#include "can.h"
-#include "can_user.h"
-
-
-// Queues for CAN1
-CANMsg_t  TxQueueCAN1[CAN1_TX_QUEUE_SIZE];
-CANMsg_t  RxQueueCAN1[CAN1_RX_QUEUE_SIZE];
-
-
-// Queues for CAN2
-CANMsg_t  TxQueueCAN2[CAN2_TX_QUEUE_SIZE];
-CANMsg_t  RxQueueCAN2[CAN2_RX_QUEUE_SIZE];
-
-
-
-// CAN_UserWrite()
-// Send a message on CAN_BUSx
-CANStatus_t  CAN_UserWrite ( CANHandle_t  hBus, CANMsg_t  *pBuff)
-{
-	CANStatus_t  ret;
-	CANMsg_t  *pMsg;
-	
-	
-	ret = CAN_ERR_OK;
-	
-	pMsg = CAN_TxQueueGetNext ( hBus);
-
-	if ( pMsg != NULL)
-	{
-		pMsg->Id   = pBuff->Id;
-		pMsg->Len  = pBuff->Len;
-		pMsg->Type = pBuff->Type;
-		
-		pMsg->Data32[0] = pBuff->Data32[0];
-		pMsg->Data32[1] = pBuff->Data32[1];
-		
-		// Send Msg
-		ret = CAN_TxQueueWriteNext ( hBus);
-	}
-	
-	else
-	{
-		// Tx Queue FULL
-		ret = CAN_ERR_FAIL;
-	}
-	
-	return ret;
-}
-
-
-
-
-// CAN_UserRead()
-// read message from CAN_BUSx
-u32_t  CAN_UserRead ( CANHandle_t  hBus, CANMsg_t  *pBuff)
-{
-	u32_t  ret;
-	CANMsg_t  *pMsg;
-	
-	
-	ret = 0;
-	
-	pMsg = CAN_RxQueueGetNext ( hBus);
-
-	if ( pMsg != NULL)
-	{
-		pBuff->Id   = pMsg->Id;
-		pBuff->Len  = pMsg->Len;
-		pBuff->Type = pMsg->Type;
-		
-		pBuff->Data32[0] = pMsg->Data32[0];
-		pBuff->Data32[1] = pMsg->Data32[1];
-		
-		CAN_RxQueueReadNext ( hBus);
-		ret = 1;
-	}
-	
-	return ret;
-}
-
-
-
-
-// CAN_UserInit()
-// initialize CAN1 and CAN2
-void  CAN_UserInit ( void)
-{
-
-	// init CAN1
-
-	CAN_ReferenceTxQueue ( CAN_BUS1, &TxQueueCAN1[0], CAN1_TX_QUEUE_SIZE);				// Reference above Arrays as Queues
-	CAN_ReferenceRxQueue ( CAN_BUS1, &RxQueueCAN1[0], CAN1_RX_QUEUE_SIZE);
-
-	CAN_SetTimestampHandler ( CAN_BUS1, NULL);
-
-	VICVectAddr1 = (u32_t) CAN_GetIsrVector ( CAN1_TX_INTSOURCE);
-	VICVectAddr3 = (u32_t) CAN_GetIsrVector ( CAN1_RX_INTSOURCE);
-
-	VICVectCntl1 = 1 << 5 | CAN1_TX_INTSOURCE;											// Setup VIC
-	VICVectCntl3 = 1 << 5 | CAN1_RX_INTSOURCE;
-
-	VICIntEnable = 1 << CAN1_TX_INTSOURCE | 1 << CAN1_RX_INTSOURCE;
-
-	CAN_SetErrorLimit ( CAN_BUS1, STD_TX_ERRORLIMIT);
-
-	CAN_SetTxErrorCallback ( CAN_BUS1, NULL);											// Set ErrorLimit & Callbacks
-	CAN_SetRxCallback ( CAN_BUS1, NULL);
-
-	CAN_SetChannelInfo ( CAN_BUS1, NULL);													// Textinfo is NULL
-
-
-	// init CAN2
-
-	CAN_ReferenceTxQueue ( CAN_BUS2, &TxQueueCAN2[0], CAN2_TX_QUEUE_SIZE);
-	CAN_ReferenceRxQueue ( CAN_BUS2, &RxQueueCAN2[0], CAN2_RX_QUEUE_SIZE);				// See above
-
-	CAN_SetTimestampHandler ( CAN_BUS2, NULL);
-
-	VICVectAddr2 = (u32_t) CAN_GetIsrVector ( CAN2_TX_INTSOURCE);
-	VICVectAddr4 = (u32_t) CAN_GetIsrVector ( CAN2_RX_INTSOURCE);
-
-	VICVectCntl2 = 1 << 5 | CAN2_TX_INTSOURCE;
-	VICVectCntl4 = 1 << 5 | CAN2_RX_INTSOURCE;
-
-	VICIntEnable = 1 << CAN2_TX_INTSOURCE | 1 << CAN2_RX_INTSOURCE;
-
-	CAN_SetErrorLimit ( CAN_BUS2, STD_TX_ERRORLIMIT);
-
-	CAN_SetTxErrorCallback ( CAN_BUS2, NULL);
-	CAN_SetRxCallback ( CAN_BUS2, NULL);
-
-	CAN_SetChannelInfo ( CAN_BUS2, NULL);
-
-
-	// Set Error Handler
-
-	VICVectAddr0 = (u32_t) CAN_GetIsrVector ( GLOBAL_CAN_INTSOURCE);
-	VICVectCntl0 = 1 << 5 | GLOBAL_CAN_INTSOURCE;
-	VICIntEnable = 1 << GLOBAL_CAN_INTSOURCE;
-
-
-	// Setup Filters
-
-	CAN_InitFilters();										// Clear Filter LUT
-	CAN_SetFilterMode ( AF_ON_BYPASS_ON);				// No Filters ( Bypassed)
-
-
-	// init CAN1 and CAN2 with Values above
-
-	CAN_InitChannel ( CAN_BUS1, CAN_BAUD_500K);
-	CAN_InitChannel ( CAN_BUS2, CAN_BAUD_500K);
-	
-	
-	//
-	CAN_SetTransceiverMode ( CAN_BUS1, CAN_TRANSCEIVER_MODE_NORMAL);
-	CAN_SetTransceiverMode ( CAN_BUS2, CAN_TRANSCEIVER_MODE_NORMAL);
-
-
-	// Busses on
-
-	CAN_SetBusMode ( CAN_BUS1, BUS_ON);					// CAN Bus On
-	CAN_SetBusMode ( CAN_BUS2, BUS_ON);
-
-}
+
+#include "datatypes.h"
+#include "lpc21xx.h"
+#include "can.h"
+#include "can_user.h"
+#include "router.h"
+#include "stats.h"
+#include "load.h"
+#include "snap.h"
+#include "busoff.h"
+#include "timer.h"
+
+
+// Queues for CAN1, Rx messages carry a timestamp
+CANMsg_t  TxQueueCAN1[CAN1_TX_QUEUE_SIZE];
+CANRxMsg_t  RxQueueCAN1[CAN1_RX_QUEUE_SIZE];
+
+
+// Queues for CAN2
+CANMsg_t  TxQueueCAN2[CAN2_TX_QUEUE_SIZE];
+CANRxMsg_t  RxQueueCAN2[CAN2_RX_QUEUE_SIZE];
+
+
+// Rx accounting: messages timestamped on interrupt level (STAT_Bus[].Rx),
+// messages taken by the Rx callback and messages freed by the main loop.
+// The difference is the Rx queue depth. Each counter has a single writer.
+static volatile u32_t  CAN_UserRxSkipped[2];
+static volatile u32_t  CAN_UserRxFreed[2];
+
+// CAN_UserRxFreed[] value of the next message to count in LOAD_Bits[],
+// CAN_UserPeek() may return the same message several times
+static u32_t  CAN_UserRxLoadNext[2];
+
+
+// Tx accounting. The library does not expose the Tx queue depth, so it
+// is estimated from the hardware: the busy transmit buffers, plus the
+// messages committed to the library while all three were busy, plus the
+// staged messages.
+#define  CAN_SR_TBS1		( 1 << 2)				// transmit buffer 1 free
+#define  CAN_SR_TBS2		( 1 << 10)
+#define  CAN_SR_TBS3		( 1 << 18)
+#define  CAN_SR_TBS_ALL	( CAN_SR_TBS1 | CAN_SR_TBS2 | CAN_SR_TBS3)
+#define  CAN_SR_TBS(n)		( CAN_SR_TBS1 << ( 8 * ( n)))
+
+#define  CAN_USER_SR(hBus)	( ( hBus) == CAN_BUS1 ? C1SR : C2SR)
+
+static u8_t  CAN_UserTxBacklog[2];
+
+static const u8_t  CAN_UserTxQueueSize[2] = { CAN1_TX_QUEUE_SIZE, CAN2_TX_QUEUE_SIZE};
+
+
+// Tx spill area. Staged messages of both busses share one pool of
+// slots, each bus keeps a binary heap of slot indexes. Equal Ids keep
+// their commit order.
+#define  CAN_USER_SLOT_LIB		0xFE			// allocated from the library queue
+#define  CAN_USER_SLOT_NONE	0xFF			// nothing allocated
+
+typedef struct {
+
+	u8_t			*pHeap;						// slots in heap order
+	
+	u8_t			Size;							// heap limit
+	u8_t			Count;						// messages in the heap
+	u8_t			Pending;						// slot from CAN_UserTxAlloc() or CAN_USER_SLOT_...
+	u8_t			N_A;
+	
+	u32_t			Seq;							// next commit order
+	
+	CANMsg_t		*pLib;						// library slot from CAN_UserTxAlloc()
+	u32_t			BufKey[3];					// key of the last message per transmit buffer
+} CAN_UserStage_t;
+
+static CANMsg_t  CAN_UserSpillMsg[CAN_USER_SPILL_SIZE];
+static u32_t  CAN_UserSpillKey[CAN_USER_SPILL_SIZE];			// arbitration key per slot
+static u32_t  CAN_UserSpillSeq[CAN_USER_SPILL_SIZE];			// commit order per slot
+static u32_t  CAN_UserSpillDue[CAN_USER_SPILL_SIZE];			// deadline per slot
+static u8_t  CAN_UserSpillFree[CAN_USER_SPILL_SIZE];			// free slots
+static u8_t  CAN_UserSpillFreeCount;
+
+static u8_t  CAN_UserStageHeapCAN1[CAN1_TX_STAGE_SIZE];
+static u8_t  CAN_UserStageHeapCAN2[CAN2_TX_STAGE_SIZE];
+
+static CAN_UserStage_t  CAN_UserStage[2] = {
+
+	{ .pHeap = CAN_UserStageHeapCAN1, .Size = CAN1_TX_STAGE_SIZE, .Pending = CAN_USER_SLOT_NONE},
+	{ .pHeap = CAN_UserStageHeapCAN2, .Size = CAN2_TX_STAGE_SIZE, .Pending = CAN_USER_SLOT_NONE}
+};
+
+
+
+// CAN_UserTxFree()
+// returns the number of free transmit buffers
+RAMFUNC static u32_t  CAN_UserTxFree ( CANHandle_t  hBus)
+{
+	u32_t  sr;
+	
+	
+	sr = CAN_USER_SR ( hBus);
+	
+	return !!( sr & CAN_SR_TBS1) + !!( sr & CAN_SR_TBS2) + !!( sr & CAN_SR_TBS3);
+}
+
+
+
+
+// CAN_UserTxKey()
+// arbitration key of a message, lower wins. A standard frame wins
+// against an extended frame with the same 11 bit base Id.
+static inline u32_t  CAN_UserTxKey ( u32_t  Id, u32_t  Type)
+{
+	if ( Type & CAN_MSG_EXTENDED)
+	{
+		return ( Id >> 18) << 19 | 1 << 18 | ( Id & 0x3FFFF);
+	}
+	
+	return Id << 19;
+}
+
+
+
+
+// CAN_UserTxExpired()
+// returns 1 if a message with Deadline is too old to be sent. The timer
+// is only read for a message with a deadline.
+static inline u32_t  CAN_UserTxExpired ( u32_t  Deadline)
+{
+	return Deadline != CAN_USER_NO_DEADLINE  &&  ( s32_t) ( TIMER_GetUs() - Deadline) >= 0;
+}
+
+
+
+
+// CAN_UserStageLess()
+// heap order: arbitration key, then commit order for equal keys
+static inline u32_t  CAN_UserStageLess ( u32_t  a, u32_t  b)
+{
+	if ( CAN_UserSpillKey[a] != CAN_UserSpillKey[b])
+	{
+		return CAN_UserSpillKey[a] < CAN_UserSpillKey[b];
+	}
+	
+	return ( s32_t) ( CAN_UserSpillSeq[a] - CAN_UserSpillSeq[b]) < 0;
+}
+
+
+
+
+// CAN_UserStageUp()
+// move Slot from heap position i towards the top and store it
+RAMFUNC static void  CAN_UserStageUp ( CAN_UserStage_t  *pS, u32_t  i, u32_t  Slot)
+{
+	u32_t  parent;
+	
+	
+	while ( i > 0)
+	{
+		parent = ( i - 1) >> 1;
+		
+		if ( !CAN_UserStageLess ( Slot, pS->pHeap[parent]))
+		{
+			break;
+		}
+		
+		pS->pHeap[i] = pS->pHeap[parent];
+		i = parent;
+	}
+	
+	pS->pHeap[i] = Slot;
+}
+
+
+
+
+// CAN_UserStageDown()
+// move Slot from heap position i towards the bottom and store it
+RAMFUNC static void  CAN_UserStageDown ( CAN_UserStage_t  *pS, u32_t  i, u32_t  Slot)
+{
+	u32_t  child;
+	
+	
+	while ( ( child = 2 * i + 1) < pS->Count)
+	{
+		if ( child + 1 < pS->Count  &&  CAN_UserStageLess ( pS->pHeap[child + 1], pS->pHeap[child]))
+		{
+			child++;
+		}
+		
+		if ( !CAN_UserStageLess ( pS->pHeap[child], Slot))
+		{
+			break;
+		}
+		
+		pS->pHeap[i] = pS->pHeap[child];
+		i = child;
+	}
+	
+	pS->pHeap[i] = Slot;
+}
+
+
+
+
+// CAN_UserStageRemove()
+// remove the slot at heap position i and return it to the pool
+RAMFUNC static u32_t  CAN_UserStageRemove ( CAN_UserStage_t  *pS, u32_t  i)
+{
+	u32_t  slot, last;
+	
+	
+	slot = pS->pHeap[i];
+	last = pS->pHeap[--pS->Count];
+	
+	if ( i < pS->Count)
+	{
+		if ( i > 0  &&  CAN_UserStageLess ( last, pS->pHeap[( i - 1) >> 1]))
+		{
+			CAN_UserStageUp ( pS, i, last);
+		}
+		
+		else
+		{
+			CAN_UserStageDown ( pS, i, last);
+		}
+	}
+	
+	CAN_UserSpillFree[CAN_UserSpillFreeCount++] = slot;
+	
+	return slot;
+}
+
+
+
+
+// CAN_UserStageExpire()
+// drop the staged messages of CAN_BUSx past their deadline and restore
+// the heap. Returns the number dropped.
+RAMFUNC static u32_t  CAN_UserStageExpire ( CANHandle_t  hBus)
+{
+	CAN_UserStage_t  *pS;
+	u32_t  i, n, slot;
+	
+	
+	pS = &CAN_UserStage[hBus];
+	n  = 0;
+	
+	for ( i = 0; i < pS->Count; i++)
+	{
+		slot = pS->pHeap[i];
+		
+		if ( CAN_UserTxExpired ( CAN_UserSpillDue[slot]))
+		{
+			CAN_UserSpillFree[CAN_UserSpillFreeCount++] = slot;
+		}
+		
+		else
+		{
+			pS->pHeap[n++] = slot;
+		}
+	}
+	
+	i = pS->Count - n;
+	pS->Count = n;
+	
+	STAT_Bus[hBus].Expired += i;
+	
+	// rebuild the heap from the rest
+	for ( n = pS->Count >> 1; n-- > 0; )
+	{
+		CAN_UserStageDown ( pS, n, pS->pHeap[n]);
+	}
+	
+	return i;
+}
+
+
+
+
+// CAN_UserTxMark()
+// remember the key of a message in the transmit buffers the library
+// loaded since Sr was read. Returns 0 if none was loaded.
+RAMFUNC static u32_t  CAN_UserTxMark ( CANHandle_t  hBus, u32_t  Sr, u32_t  Key)
+{
+	u32_t  taken, b;
+	
+	
+	taken = Sr & ~CAN_USER_SR ( hBus) & CAN_SR_TBS_ALL;
+	
+	for ( b = 0; b < 3; b++)
+	{
+		if ( taken & CAN_SR_TBS ( b))
+		{
+			CAN_UserStage[hBus].BufKey[b] = Key;
+		}
+	}
+	
+	return taken != 0;
+}
+
+
+
+
+// CAN_UserTxInFlight()
+// returns 1 if a busy transmit buffer holds a message with Key. The
+// hardware sends equal Ids in buffer order, not in load order, so a
+// message waits until its predecessor with the same Id is gone.
+RAMFUNC static u32_t  CAN_UserTxInFlight ( CANHandle_t  hBus, u32_t  Sr, u32_t  Key)
+{
+	u32_t  b;
+	
+	
+	for ( b = 0; b < 3; b++)
+	{
+		if ( !( Sr & CAN_SR_TBS ( b))  &&  CAN_UserStage[hBus].BufKey[b] == Key)
+		{
+			return 1;
+		}
+	}
+	
+	return 0;
+}
+
+
+
+
+// CAN_UserTxPump()
+// move staged messages to the library queue while a transmit buffer is
+// free. The library loads a free buffer at once, so its queue stays
+// empty and the hardware picks the lowest Id of the three buffers.
+// Nothing moves while the bus is off, BUSOFF_Task() purges the staged
+// messages before the bus goes on again.
+RAMFUNC static void  CAN_UserTxPump ( CANHandle_t  hBus)
+{
+	CAN_UserStage_t  *pS;
+	CANMsg_t  *pMsg;
+	u32_t  sr, slot;
+	
+	
+	if ( BUSOFF_IsOff ( hBus))
+	{
+		return;
+	}
+	
+	pS = &CAN_UserStage[hBus];
+	sr = CAN_USER_SR ( hBus);
+	
+	while ( pS->Count > 0  &&  ( sr & CAN_SR_TBS_ALL))
+	{
+		slot = pS->pHeap[0];
+		
+		// too late, the next one may still be in time
+		if ( CAN_UserTxExpired ( CAN_UserSpillDue[slot]))
+		{
+			CAN_UserStageRemove ( pS, 0);
+			STAT_Bus[hBus].Expired++;
+			continue;
+		}
+		
+		if ( CAN_UserTxInFlight ( hBus, sr, CAN_UserSpillKey[slot]))
+		{
+			break;
+		}
+		
+		pMsg = CAN_TxQueueGetNext ( hBus);
+		
+		if ( pMsg == NULL)
+		{
+			break;
+		}
+		
+		// the slot stays valid until the next allocation
+		CAN_UserStageRemove ( pS, 0);
+		
+		CAN_UserCopy ( pMsg, &CAN_UserSpillMsg[slot]);
+		CAN_TxQueueWriteNext ( hBus);
+		LOAD_Count ( hBus, pMsg->Type, pMsg->Len);
+		
+		// stop if the library kept the message in its queue
+		if ( !CAN_UserTxMark ( hBus, sr, CAN_UserSpillKey[slot]))
+		{
+			break;
+		}
+		
+		sr = CAN_USER_SR ( hBus);
+	}
+}
+
+
+
+
+// CAN_UserTxAlloc()
+// returns a free Tx slot of CAN_BUSx or NULL when the queue is full.
+// Fill it in and send it with CAN_UserTxCommit(). On main() level the
+// caller has to hold CAN_UserLock() until the commit. The slot is taken
+// from the library queue when all transmit buffers are free and the
+// bus is on, from the spill area otherwise.
+RAMFUNC CANMsg_t*  CAN_UserTxAlloc ( CANHandle_t  hBus)
+{
+	CAN_UserStage_t  *pS;
+	CANMsg_t  *pMsg;
+	u32_t  free, depth, slot;
+	
+	
+	pS = &CAN_UserStage[hBus];
+	
+	// allocated before but not committed
+	if ( pS->Pending < CAN_USER_SLOT_LIB)
+	{
+		return &CAN_UserSpillMsg[pS->Pending];
+	}
+	
+	free  = CAN_UserTxFree ( hBus);
+	depth = 3 - free;
+	
+	if ( free > 0)
+	{
+		CAN_UserTxBacklog[hBus] = 0;
+	}
+	
+	depth += CAN_UserTxBacklog[hBus] + pS->Count;
+	
+	STAT_Sample ( STAT_HIST_TXQ_CAN1 + hBus, depth);
+	STAT_Hwm ( &STAT_Bus[hBus].TxHwm, depth);
+	
+	// fast path, straight to the library
+	if ( pS->Count == 0  &&  free == 3  &&  !BUSOFF_IsOff ( hBus))
+	{
+		pMsg = CAN_TxQueueGetNext ( hBus);
+		
+		if ( pMsg != NULL)
+		{
+			pS->Pending = CAN_USER_SLOT_LIB;
+			pS->pLib    = pMsg;
+			
+			return pMsg;
+		}
+	}
+	
+	// make room from the messages past their deadline
+	if ( ( pS->Count >= pS->Size  ||  CAN_UserSpillFreeCount == 0)  &&  CAN_UserStageExpire ( hBus) == 0)
+	{
+		return NULL;
+	}
+	
+	slot = CAN_UserSpillFree[--CAN_UserSpillFreeCount];
+	pS->Pending = slot;
+	
+	return &CAN_UserSpillMsg[slot];
+}
+
+
+
+
+// CAN_UserTxCommit()
+// send the slot returned by CAN_UserTxAlloc(). A message past Deadline
+// is dropped instead, CAN_USER_NO_DEADLINE for none.
+RAMFUNC CANStatus_t  CAN_UserTxCommit ( CANHandle_t  hBus, u32_t  Deadline)
+{
+	CAN_UserStage_t  *pS;
+	CANStatus_t  ret;
+	u32_t  slot, sr;
+	
+	
+	pS   = &CAN_UserStage[hBus];
+	slot = pS->Pending;
+	
+	pS->Pending = CAN_USER_SLOT_NONE;
+	
+	if ( slot == CAN_USER_SLOT_NONE)
+	{
+		return CAN_ERR_FAIL;
+	}
+	
+	// the library slot is left unused, a spill slot goes back to the pool
+	if ( CAN_UserTxExpired ( Deadline))
+	{
+		if ( slot != CAN_USER_SLOT_LIB)
+		{
+			CAN_UserSpillFree[CAN_UserSpillFreeCount++] = slot;
+		}
+		
+		STAT_Bus[hBus].Expired++;
+		
+		return CAN_ERR_FAIL;
+	}
+	
+	if ( slot == CAN_USER_SLOT_LIB)
+	{
+		LOAD_Count ( hBus, pS->pLib->Type, pS->pLib->Len);
+		
+		sr  = CAN_USER_SR ( hBus);
+		ret = CAN_TxQueueWriteNext ( hBus);
+		
+		CAN_UserTxMark ( hBus, sr, CAN_UserTxKey ( pS->pLib->Id, pS->pLib->Type));
+		
+		if ( ( CAN_USER_SR ( hBus) & CAN_SR_TBS_ALL) == 0  &&
+				CAN_UserTxBacklog[hBus] < CAN_UserTxQueueSize[hBus])
+		{
+			CAN_UserTxBacklog[hBus]++;
+		}
+		
+		return ret;
+	}
+	
+	CAN_UserSpillKey[slot] = CAN_UserTxKey ( CAN_UserSpillMsg[slot].Id, CAN_UserSpillMsg[slot].Type);
+	CAN_UserSpillSeq[slot] = pS->Seq++;
+	CAN_UserSpillDue[slot] = Deadline;
+	
+	CAN_UserStageUp ( pS, pS->Count++, slot);
+	CAN_UserTxPump ( hBus);
+	
+	return CAN_ERR_OK;
+}
+
+
+
+
+// CAN_UserTxCancel()
+// give back the slot returned by CAN_UserTxAlloc() without sending it.
+// A library slot is only taken by the commit, a spill slot goes back to
+// the pool.
+void  CAN_UserTxCancel ( CANHandle_t  hBus)
+{
+	CAN_UserStage_t  *pS;
+	
+	
+	pS = &CAN_UserStage[hBus];
+	
+	if ( pS->Pending < CAN_USER_SLOT_LIB)
+	{
+		CAN_UserSpillFree[CAN_UserSpillFreeCount++] = pS->Pending;
+	}
+	
+	pS->Pending = CAN_USER_SLOT_NONE;
+}
+
+
+
+
+// CAN_UserTxStaged()
+// returns the staged message of CAN_BUSx with Id and Type or NULL. The
+// caller may overwrite its length and data while holding CAN_UserLock(),
+// the message keeps its place.
+RAMFUNC CANMsg_t*  CAN_UserTxStaged ( CANHandle_t  hBus, u32_t  Id, u32_t  Type)
+{
+	CAN_UserStage_t  *pS;
+	u32_t  key, i, slot;
+	
+	
+	pS  = &CAN_UserStage[hBus];
+	key = CAN_UserTxKey ( Id, Type);
+	
+	for ( i = 0; i < pS->Count; i++)
+	{
+		slot = pS->pHeap[i];
+		
+		if ( CAN_UserSpillKey[slot] == key  &&  CAN_UserSpillMsg[slot].Type == Type)
+		{
+			return &CAN_UserSpillMsg[slot];
+		}
+	}
+	
+	return NULL;
+}
+
+
+
+
+// CAN_UserTxRenew()
+// set a new deadline for a message returned by CAN_UserTxStaged()
+RAMFUNC void  CAN_UserTxRenew ( CANMsg_t  *pStaged, u32_t  Deadline)
+{
+	CAN_UserSpillDue[pStaged - CAN_UserSpillMsg] = Deadline;
+}
+
+
+
+
+// CAN_UserTxDropOldest()
+// drop the staged message of CAN_BUSx committed first. Returns 0 when
+// nothing is staged.
+u32_t  CAN_UserTxDropOldest ( CANHandle_t  hBus)
+{
+	CAN_UserStage_t  *pS;
+	u32_t  i, oldest, slot;
+	
+	
+	pS = &CAN_UserStage[hBus];
+	
+	if ( pS->Count == 0)
+	{
+		return 0;
+	}
+	
+	oldest = 0;
+	
+	for ( i = 1; i < pS->Count; i++)
+	{
+		slot = pS->pHeap[i];
+		
+		if ( ( s32_t) ( CAN_UserSpillSeq[slot] - CAN_UserSpillSeq[pS->pHeap[oldest]]) < 0)
+		{
+			oldest = i;
+		}
+	}
+	
+	CAN_UserStageRemove ( pS, oldest);
+	STAT_Bus[hBus].TxDrop++;
+	
+	return 1;
+}
+
+
+
+
+// CAN_UserTxStagedCount()
+// returns the number of staged messages of CAN_BUSx
+u32_t  CAN_UserTxStagedCount ( CANHandle_t  hBus)
+{
+	return CAN_UserStage[hBus].Count;
+}
+
+
+
+
+// CAN_UserTxPurge()
+// drop all messages of CAN_BUSx which wait for a transmit buffer, the
+// staged ones and those in the library queue. Returns their number, the
+// library part as estimated by CAN_UserTxBacklog[]. The caller holds
+// CAN_UserLock().
+u32_t  CAN_UserTxPurge ( CANHandle_t  hBus)
+{
+	CAN_UserStage_t  *pS;
+	u32_t  n, mask, en;
+	
+	
+	pS = &CAN_UserStage[hBus];
+	n  = pS->Count;
+	
+	while ( pS->Count > 0)
+	{
+		CAN_UserSpillFree[CAN_UserSpillFreeCount++] = pS->pHeap[--pS->Count];
+	}
+	
+	// the library has no flush, referencing the queue again empties it.
+	// Its Tx interrupt must not load from the queue meanwhile.
+	mask = hBus == CAN_BUS1 ? 1 << CAN1_TX_INTSOURCE : 1 << CAN2_TX_INTSOURCE;
+	en   = VICIntEnable & mask;
+	
+	VICIntEnClr = mask;
+	
+	if ( hBus == CAN_BUS1)
+	{
+		CAN_ReferenceTxQueue ( CAN_BUS1, &TxQueueCAN1[0], CAN1_TX_QUEUE_SIZE);
+	}
+	
+	else
+	{
+		CAN_ReferenceTxQueue ( CAN_BUS2, &TxQueueCAN2[0], CAN2_TX_QUEUE_SIZE);
+	}
+	
+	VICIntEnable = en;
+	
+	n += CAN_UserTxBacklog[hBus];
+	CAN_UserTxBacklog[hBus] = 0;
+	
+	return n;
+}
+
+
+
+
+// CAN_UserTxTask()
+// called from the main loop, feeds free transmit buffers from staging
+RAMFUNC void  CAN_UserTxTask ( void)
+{
+	u32_t  lock;
+	
+	
+	lock = CAN_UserLock();
+	
+	CAN_UserTxPump ( CAN_BUS1);
+	CAN_UserTxPump ( CAN_BUS2);
+	
+	CAN_UserUnlock ( lock);
+}
+
+
+
+
+// CAN_UserWrite()
+// Send a message on CAN_BUSx, dropped when it is still waiting for a
+// transmit buffer at Deadline
+CANStatus_t  CAN_UserWrite ( CANHandle_t  hBus, CANMsg_t  *pBuff, u32_t  Deadline)
+{
+	CANStatus_t  ret;
+	CANMsg_t  *pMsg;
+	u32_t  lock;
+	
+	
+	ret = CAN_ERR_OK;
+	
+	lock = CAN_UserLock();
+	
+	pMsg = CAN_UserTxAlloc ( hBus);
+	
+	if ( pMsg != NULL)
+	{
+		CAN_UserCopy ( pMsg, pBuff);
+		
+		// Send Msg
+		ret = CAN_UserTxCommit ( hBus, Deadline);
+	}
+	
+	else
+	{
+		// Tx Queue FULL, the message is lost
+		STAT_Bus[hBus].TxDrop++;
+		ret = CAN_ERR_FAIL;
+	}
+	
+	CAN_UserUnlock ( lock);
+	
+	return ret;
+}
+
+
+
+
+// CAN_UserRead()
+// read message from CAN_BUSx
+u32_t  CAN_UserRead ( CANHandle_t  hBus, CANMsg_t  *pBuff)
+{
+	u32_t  ret;
+	CANRxMsg_t  *pMsg;
+	
+	
+	ret = 0;
+	
+	pMsg = CAN_UserPeek ( hBus);
+	
+	if ( pMsg != NULL)
+	{
+		CAN_UserCopy ( pBuff, ( CANMsg_t *) pMsg);
+		
+		CAN_UserRelease ( hBus);
+		ret = 1;
+	}
+	
+	return ret;
+}
+
+
+
+
+// CAN_UserPeek()
+// returns the next message from the Rx queue of CAN_BUSx without
+// freeing it, NULL when the queue is empty
+RAMFUNC CANRxMsg_t*  CAN_UserPeek ( CANHandle_t  hBus)
+{
+	CANRxMsg_t  *pMsg;
+	u32_t  in, depth, lock;
+	
+	
+	lock = CAN_UserLock();
+	
+	// sample before looking at the queue. An empty queue means every
+	// message counted so far is gone, also those lost on a Rx overrun.
+	in = STAT_Bus[hBus].Rx;
+	
+	pMsg = CAN_RxQueueGetNext ( hBus);
+	
+	depth = in - CAN_UserRxSkipped[hBus] - CAN_UserRxFreed[hBus];
+	
+	if ( pMsg == NULL)
+	{
+		// whatever is still counted was lost
+		STAT_Bus[hBus].RxLost   += depth;
+		CAN_UserRxFreed[hBus] += depth;
+	}
+	
+	else
+	{
+		STAT_Sample ( STAT_HIST_RXQ_CAN1 + hBus, depth);
+		STAT_Hwm ( &STAT_Bus[hBus].RxHwm, depth);
+		
+		if ( ( s32_t) ( CAN_UserRxFreed[hBus] - CAN_UserRxLoadNext[hBus]) >= 0)
+		{
+			CAN_UserRxLoadNext[hBus] = CAN_UserRxFreed[hBus] + 1;
+			LOAD_Count ( hBus, pMsg->Type, pMsg->Len);
+			SNAP_Update ( hBus, pMsg);
+		}
+	}
+	
+	CAN_UserUnlock ( lock);
+	
+	return pMsg;
+}
+
+
+
+
+// CAN_UserRelease()
+// free the message returned by CAN_UserPeek()
+RAMFUNC void  CAN_UserRelease ( CANHandle_t  hBus)
+{
+	CAN_RxQueueReadNext ( hBus);
+	CAN_UserRxFreed[hBus]++;
+}
+
+
+
+
+#if CAN_USER_ISR_FORWARD
+
+// CAN_UserRxIsr()
+// route a received message on interrupt level. Messages which can not
+// be sent now are left to the main loop.
+RAMFUNC static u32_t  CAN_UserRxIsr ( CANHandle_t  hSrc, CANRxMsg_t  *pMsg)
+{
+	// main loop still has older messages, queue behind them. This
+	// message is already counted by the timestamp handler.
+	if ( STAT_Bus[hSrc].Rx - 1 == CAN_UserRxSkipped[hSrc] + CAN_UserRxFreed[hSrc])
+	{
+		if ( ROUTE_Process ( hSrc, pMsg) != ROUTE_RETRY)
+		{
+			CAN_UserRxSkipped[hSrc]++;
+			LOAD_Count ( hSrc, pMsg->Type, pMsg->Len);
+			SNAP_Update ( hSrc, pMsg);
+			
+			return SKIP_MESSAGE;
+		}
+	}
+	
+	return LEAVE_MESSAGE;
+}
+
+
+
+
+// Rx callbacks for CAN1 and CAN2
+RAMFUNC static u32_t  CAN_UserRxCallbackCAN1 ( void  *pMsg)
+{
+	return CAN_UserRxIsr ( CAN_BUS1, pMsg);
+}
+
+
+RAMFUNC static u32_t  CAN_UserRxCallbackCAN2 ( void  *pMsg)
+{
+	return CAN_UserRxIsr ( CAN_BUS2, pMsg);
+}
+
+#endif
+
+
+
+
+// Timestamp handlers for CAN1 and CAN2, called on interrupt level for
+// every Rx message before its data is valid
+RAMFUNC static void  CAN_UserTimestampCAN1 ( CANRxMsg_t  *pMsg)
+{
+	pMsg->TimeStamp32 = TIMER_GetUs();
+	STAT_Bus[CAN_BUS1].Rx++;
+}
+
+
+RAMFUNC static void  CAN_UserTimestampCAN2 ( CANRxMsg_t  *pMsg)
+{
+	pMsg->TimeStamp32 = TIMER_GetUs();
+	STAT_Bus[CAN_BUS2].Rx++;
+}
+
+
+
+
+// CAN_UserInit()
+// initialize CAN1 and CAN2
+void  CAN_UserInit ( void)
+{
+	u32_t  i;
+	
+	
+	// Tx spill area, all slots free
+	
+	for ( i = 0; i < CAN_USER_SPILL_SIZE; i++)
+	{
+		CAN_UserSpillFree[i] = i;
+	}
+	
+	CAN_UserSpillFreeCount = CAN_USER_SPILL_SIZE;
+	
+	
+	// init CAN1
+	
+	CAN_ReferenceTxQueue ( CAN_BUS1, &TxQueueCAN1[0], CAN1_TX_QUEUE_SIZE);				// Reference above Arrays as Queues
+	CAN_ReferenceRxQueue ( CAN_BUS1, &RxQueueCAN1[0], CAN1_RX_QUEUE_SIZE);
+	
+	CAN_SetTimestampHandler ( CAN_BUS1, CAN_UserTimestampCAN1);							// Rx queue is CANRxMsg_t
+	
+	VICVectAddr1 = (u32_t) CAN_GetIsrVector ( CAN1_TX_INTSOURCE);
+	VICVectAddr3 = (u32_t) CAN_GetIsrVector ( CAN1_RX_INTSOURCE);
+	
+	VICVectCntl1 = 1 << 5 | CAN1_TX_INTSOURCE;											// Setup VIC
+	VICVectCntl3 = 1 << 5 | CAN1_RX_INTSOURCE;
+	
+	VICIntEnable = 1 << CAN1_TX_INTSOURCE | 1 << CAN1_RX_INTSOURCE;
+	
+	CAN_SetErrorLimit ( CAN_BUS1, STD_TX_ERRORLIMIT);
+	
+	CAN_SetTxErrorCallback ( CAN_BUS1, BUSOFF_TxErrorCAN1);							// Set ErrorLimit & Callbacks, bus off see busoff.c
+#if CAN_USER_ISR_FORWARD
+	CAN_SetRxCallback ( CAN_BUS1, CAN_UserRxCallbackCAN1);							// forward on interrupt level
+#else
+	CAN_SetRxCallback ( CAN_BUS1, NULL);
+#endif
+	
+	CAN_SetChannelInfo ( CAN_BUS1, NULL);													// Textinfo is NULL
+	
+	
+	// init CAN2
+	
+	CAN_ReferenceTxQueue ( CAN_BUS2, &TxQueueCAN2[0], CAN2_TX_QUEUE_SIZE);
+	CAN_ReferenceRxQueue ( CAN_BUS2, &RxQueueCAN2[0], CAN2_RX_QUEUE_SIZE);				// See above
+	
+	CAN_SetTimestampHandler ( CAN_BUS2, CAN_UserTimestampCAN2);
+	
+	VICVectAddr2 = (u32_t) CAN_GetIsrVector ( CAN2_TX_INTSOURCE);
+	VICVectAddr4 = (u32_t) CAN_GetIsrVector ( CAN2_RX_INTSOURCE);
+	
+	VICVectCntl2 = 1 << 5 | CAN2_TX_INTSOURCE;
+	VICVectCntl4 = 1 << 5 | CAN2_RX_INTSOURCE;
+	
+	VICIntEnable = 1 << CAN2_TX_INTSOURCE | 1 << CAN2_RX_INTSOURCE;
+	
+	CAN_SetErrorLimit ( CAN_BUS2, STD_TX_ERRORLIMIT);
+	
+	CAN_SetTxErrorCallback ( CAN_BUS2, BUSOFF_TxErrorCAN2);
+#if CAN_USER_ISR_FORWARD
+	CAN_SetRxCallback ( CAN_BUS2, CAN_UserRxCallbackCAN2);
+#else
+	CAN_SetRxCallback ( CAN_BUS2, NULL);
+#endif
+	
+	CAN_SetChannelInfo ( CAN_BUS2, NULL);
+	
+	
+	// Set Error Handler
+	
+	VICVectAddr0 = (u32_t) CAN_GetIsrVector ( GLOBAL_CAN_INTSOURCE);
+	VICVectCntl0 = 1 << 5 | GLOBAL_CAN_INTSOURCE;
+	VICIntEnable = 1 << GLOBAL_CAN_INTSOURCE;
+	
+	
+	// Setup Filters
+	
+	ROUTE_InitFilters();									// Routing rules to the LUT
+	
+	
+	// init CAN1 and CAN2 with Values above
+	
+	CAN_InitChannel ( CAN_BUS1, CAN_USER_BAUD_CAN1);
+	CAN_InitChannel ( CAN_BUS2, CAN_USER_BAUD_CAN2);
+	
+	
+	//
+	CAN_SetTransceiverMode ( CAN_BUS1, CAN_TRANSCEIVER_MODE_NORMAL);
+	CAN_SetTransceiverMode ( CAN_BUS2, CAN_TRANSCEIVER_MODE_NORMAL);
+	
+	
+	// Busses on
+	
+	CAN_SetBusMode ( CAN_BUS1, BUS_ON);					// CAN Bus On
+	CAN_SetBusMode ( CAN_BUS2, BUS_ON);
+
+}
@@ -1,44 +1,217 @@
-
-#ifndef  _CAN_USER_H_
-#define  _CAN_USER_H_
-
-
-// defines
-#define  CAN1_TX_QUEUE_SIZE	8
-#define  CAN1_RX_QUEUE_SIZE	16
-
-#define  CAN2_TX_QUEUE_SIZE	8
-#define  CAN2_RX_QUEUE_SIZE	16
-
-
-// Baudrates
-// VPB clock 60 MHz, 15 Tsegs, sample point 80 %
-//											-- SJW --	- Tseg1 -	- Tseg2 -	- BRP -
-#define		CAN_BAUD_1M			(	0 << 14 |	10 << 16 |	2 << 20 |	3)
-#define		CAN_BAUD_800K		(	0 << 14 |	10 << 16 |	2 << 20 |	4)
-#define		CAN_BAUD_500K		(	0 << 14 |	10 << 16 |	2 << 20 |	7)
-#define		CAN_BAUD_250K		(	0 << 14 |	10 << 16 |	2 << 20 |	15)
-#define		CAN_BAUD_200K		(	0 << 14 |	10 << 16 |	2 << 20 |	19)
-#define		CAN_BAUD_125K		(	0 << 14 |	10 << 16 |	2 << 20 |	31)
-#define		CAN_BAUD_100K		(	0 << 14 |	10 << 16 |	2 << 20 |	39)
-#define		CAN_BAUD_95K2		(	0 << 14 |	10 << 16 |	2 << 20 |	41)
-#define		CAN_BAUD_83K3		(	0 << 14 |	10 << 16 |	2 << 20 |	47)
-#define		CAN_BAUD_50K		(	0 << 14 |	10 << 16 |	2 << 20 |	79)
-#define		CAN_BAUD_47K6		(	0 << 14 |	10 << 16 |	2 << 20 |	83)
-#define		CAN_BAUD_33K3		(	0 << 14 |	10 << 16 |	2 << 20 |	119)
-#define		CAN_BAUD_20K		(	0 << 14 |	10 << 16 |	2 << 20 |	199)
-#define		CAN_BAUD_10K		(	0 << 14 |	10 << 16 |	2 << 20 |	399)
-
-
-// user function protos
-
-CANStatus_t  CAN_UserWrite ( CANHandle_t  hBus, CANMsg_t  *pBuff);
-
-
-u32_t  CAN_UserRead ( CANHandle_t  hBus, CANMsg_t  *pBuff);
-
-
-void  CAN_UserInit ( void);
-
-
-#endif
+
+#ifndef  _CAN_USER_H_
+#define  _CAN_USER_H_
+
+
+// defines
+#define  CAN1_TX_QUEUE_SIZE	8
+#define  CAN1_RX_QUEUE_SIZE	16
+
+#define  CAN2_TX_QUEUE_SIZE	8
+#define  CAN2_RX_QUEUE_SIZE	16
+
+
+// Tx spill area, up to 254 messages shared by both busses. Messages wait
+// there in CAN arbitration order while all transmit buffers are busy.
+// A bus holds at most CANx_TX_STAGE_SIZE of them, so a congested or bus
+// off bus can't take the whole area.
+#ifndef  CAN_USER_SPILL_SIZE
+#define  CAN_USER_SPILL_SIZE	32
+#endif
+
+#ifndef  CAN1_TX_STAGE_SIZE
+#define  CAN1_TX_STAGE_SIZE	24
+#endif
+
+#ifndef  CAN2_TX_STAGE_SIZE
+#define  CAN2_TX_STAGE_SIZE	24
+#endif
+
+
+// Forward on interrupt level from the Rx callbacks. Messages which can't
+// be sent there are left in the Rx queue for the main loop.
+#ifndef  CAN_USER_ISR_FORWARD
+#define  CAN_USER_ISR_FORWARD	0
+#endif
+
+
+// RAM resident hot path, make FASTRUN=1. RAMFUNC functions are linked
+// into .fastrun, which crt0.S copies to RAM with .data, and run there as
+// ARM code without flash wait states. RAM is out of reach of a bl from
+// flash, so they are called with long calls. The files which hold them
+// are built with -mlong-calls for their calls back into flash.
+// Not measured on the target yet: neither the gain of make bench
+// FASTRUN=1 over make bench nor the make ramsize of a FASTRUN=1 build,
+// check both before turning it on.
+#ifndef  FASTRUN
+#define  FASTRUN					0
+#endif
+
+#if FASTRUN  &&  !defined ( SIM_HOST)
+#ifdef __thumb__
+#define  RAMFUNC					__attribute__ ( ( section ( ".fastrun"), long_call, target ( "arm")))
+#else
+#define  RAMFUNC					__attribute__ ( ( section ( ".fastrun"), long_call))
+#endif
+#else
+#define  RAMFUNC
+#endif
+
+// a rarely taken path of a RAMFUNC function which stays in flash, it
+// must not be inlined into its caller
+#if FASTRUN  &&  !defined ( SIM_HOST)
+#define  FLASHFUNC				__attribute__ ( ( noinline))
+#else
+#define  FLASHFUNC
+#endif
+
+
+// Interrupt protection for main() level code that holds a Tx slot. The
+// Rx callbacks write to the Tx queues and the counters of STAT_Bus, so
+// their interrupts are masked. The lock nests: CAN_UserLock() returns
+// the Rx interrupts enabled before, CAN_UserUnlock() enables just those
+// again, so CAN_UserWrite() inside a locked section keeps it locked.
+// Users need lpc21xx.h for the VIC registers.
+#if CAN_USER_ISR_FORWARD
+#define  CAN_USER_RX_INTMASK	( 1 << CAN1_RX_INTSOURCE | 1 << CAN2_RX_INTSOURCE)
+
+// CAN_UserLock()
+// mask the Rx interrupts, returns those which were enabled
+static inline u32_t  CAN_UserLock ( void)
+{
+	u32_t  en;
+	
+	
+	en = VICIntEnable & CAN_USER_RX_INTMASK;
+	VICIntEnClr = CAN_USER_RX_INTMASK;
+	
+	return en;
+}
+
+
+// CAN_UserUnlock()
+// enable the Rx interrupts returned by CAN_UserLock()
+static inline void  CAN_UserUnlock ( u32_t  En)
+{
+	VICIntEnable = En;
+}
+#else
+#define  CAN_UserLock()			0
+#define  CAN_UserUnlock(En)		( ( void) ( En))
+#endif
+
+
+// Tx deadline, a TIMER_GetUs() time. A staged message which is still
+// waiting for a transmit buffer at its deadline is dropped.
+#define  CAN_USER_NO_DEADLINE	0
+
+
+// Error state bits of CnGSR
+#define  CAN_GSR_ES				( 1 << 6)				// error counter at warning limit
+#define  CAN_GSR_BS				( 1 << 7)				// bus off
+#define  CAN_GSR_RXERR(gsr)	( ( ( gsr) >> 16) & 0xFF)
+#define  CAN_GSR_TXERR(gsr)	( ( gsr) >> 24)
+
+
+// Baudrates
+// VPB clock 60 MHz, 15 Tsegs, sample point 80 %
+//											-- SJW --	- Tseg1 -	- Tseg2 -	- BRP -
+#define		CAN_BAUD_1M			(	0 << 14 |	10 << 16 |	2 << 20 |	3)
+#define		CAN_BAUD_800K		(	0 << 14 |	10 << 16 |	2 << 20 |	4)
+#define		CAN_BAUD_500K		(	0 << 14 |	10 << 16 |	2 << 20 |	7)
+#define		CAN_BAUD_250K		(	0 << 14 |	10 << 16 |	2 << 20 |	15)
+#define		CAN_BAUD_200K		(	0 << 14 |	10 << 16 |	2 << 20 |	19)
+#define		CAN_BAUD_125K		(	0 << 14 |	10 << 16 |	2 << 20 |	31)
+#define		CAN_BAUD_100K		(	0 << 14 |	10 << 16 |	2 << 20 |	39)
+#define		CAN_BAUD_95K2		(	0 << 14 |	10 << 16 |	2 << 20 |	41)
+#define		CAN_BAUD_83K3		(	0 << 14 |	10 << 16 |	2 << 20 |	47)
+#define		CAN_BAUD_50K		(	0 << 14 |	10 << 16 |	2 << 20 |	79)
+#define		CAN_BAUD_47K6		(	0 << 14 |	10 << 16 |	2 << 20 |	83)
+#define		CAN_BAUD_33K3		(	0 << 14 |	10 << 16 |	2 << 20 |	119)
+#define		CAN_BAUD_20K		(	0 << 14 |	10 << 16 |	2 << 20 |	199)
+#define		CAN_BAUD_10K		(	0 << 14 |	10 << 16 |	2 << 20 |	399)
+
+// bit rate of a CAN_BAUD_... value, needs timer.h
+#define		CAN_BAUD_BITRATE(btr)	( TIMER_PCLK / ( ( ( ( btr) & 0x3FF) + 1) * ( ( ( btr) >> 16 & 0xF) + ( ( btr) >> 20 & 7) + 3)))
+
+
+// Bit timing of the busses
+#ifndef  CAN_USER_BAUD_CAN1
+#define  CAN_USER_BAUD_CAN1	CAN_BAUD_500K
+#endif
+
+#ifndef  CAN_USER_BAUD_CAN2
+#define  CAN_USER_BAUD_CAN2	CAN_BAUD_500K
+#endif
+
+
+// CAN_UserCopy()
+// copy Id, type, length and data of a message
+static inline void  CAN_UserCopy ( CANMsg_t  *pDst, const CANMsg_t  *pSrc)
+{
+	pDst->Id   = pSrc->Id;
+	pDst->Len  = pSrc->Len;
+	pDst->Type = pSrc->Type;
+	
+	pDst->Data32[0] = pSrc->Data32[0];
+	pDst->Data32[1] = pSrc->Data32[1];
+}
+
+
+// CAN_UserDeadline()
+// returns the deadline of a message received at TimeStamp which may be
+// at most MaxAgeUs old when it is sent
+static inline u32_t  CAN_UserDeadline ( u32_t  TimeStamp, u32_t  MaxAgeUs)
+{
+	u32_t  due = TimeStamp + MaxAgeUs;
+	
+	
+	return due != CAN_USER_NO_DEADLINE ? due : 1;
+}
+
+
+// user function protos
+
+RAMFUNC CANMsg_t*  CAN_UserTxAlloc ( CANHandle_t  hBus);
+
+
+RAMFUNC CANStatus_t  CAN_UserTxCommit ( CANHandle_t  hBus, u32_t  Deadline);
+
+
+void  CAN_UserTxCancel ( CANHandle_t  hBus);
+
+
+RAMFUNC CANMsg_t*  CAN_UserTxStaged ( CANHandle_t  hBus, u32_t  Id, u32_t  Type);
+
+
+RAMFUNC void  CAN_UserTxRenew ( CANMsg_t  *pStaged, u32_t  Deadline);
+
+
+u32_t  CAN_UserTxDropOldest ( CANHandle_t  hBus);
+
+
+u32_t  CAN_UserTxStagedCount ( CANHandle_t  hBus);
+
+
+u32_t  CAN_UserTxPurge ( CANHandle_t  hBus);
+
+
+RAMFUNC void  CAN_UserTxTask ( void);
+
+
+CANStatus_t  CAN_UserWrite ( CANHandle_t  hBus, CANMsg_t  *pBuff, u32_t  Deadline);
+
+
+u32_t  CAN_UserRead ( CANHandle_t  hBus, CANMsg_t  *pBuff);
+
+
+RAMFUNC CANRxMsg_t*  CAN_UserPeek ( CANHandle_t  hBus);
+
+
+RAMFUNC void  CAN_UserRelease ( CANHandle_t  hBus);
+
+
+void  CAN_UserInit ( void);
+
+
+#endif
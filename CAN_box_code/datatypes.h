@@ -1,42 +1,42 @@
-#ifndef _DATA_TYPES_H
-#define _DATA_TYPES_H
-
-//
-//	datatypes.h
-//	~~~~~~~~~~~
-//
-//	-------------------------------------------------------------------
-//
-//	base types
-//
-//	-------------------------------------------------------------------
-//
-//	Copyright (C) 1999-2011  PEAK-System Technik GmbH, Darmstadt
-//	more Info at http://www.peak-system.com 
-//
-
-
-#ifndef NULL
-#define	NULL		((void*)0)
-#endif
-
-
-typedef		unsigned char		u8_t;			// unsigned
-typedef		signed char			s8_t;			// signed
-typedef		char					b8_t;			// blank
-
-typedef		unsigned short		u16_t;
-typedef		signed short		s16_t;
-typedef		short					b16_t;
-
-typedef		unsigned int		u32_t;
-typedef		signed int			s32_t;
-typedef		int					b32_t;
-
-typedef		unsigned long long	u64_t;
-typedef		signed long long		s64_t;
-typedef		long long				b64_t;
-
-
-
-#endif
+#ifndef _DATA_TYPES_H
+#define _DATA_TYPES_H
+
+//
+//	datatypes.h
+//	~~~~~~~~~~~
+//
+//	-------------------------------------------------------------------
+//
+//	base types
+//
+//	-------------------------------------------------------------------
+//
+//	Copyright (C) 1999-2011  PEAK-System Technik GmbH, Darmstadt
+//	more Info at http://www.peak-system.com 
+//
+
+
+#ifndef NULL
+#define	NULL		((void*)0)
+#endif
+
+
+typedef		unsigned char		u8_t;			// unsigned
+typedef		signed char			s8_t;			// signed
+typedef		char					b8_t;			// blank
+
+typedef		unsigned short		u16_t;
+typedef		signed short		s16_t;
+typedef		short					b16_t;
+
+typedef		unsigned int		u32_t;
+typedef		signed int			s32_t;
+typedef		int					b32_t;
+
+typedef		unsigned long long	u64_t;
+typedef		signed long long		s64_t;
+typedef		long long				b64_t;
+
+
+
+#endif
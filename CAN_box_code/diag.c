@@ -0,0 +1,465 @@
+
+#include "datatypes.h"
+#include "lpc21xx.h"
+#include "can.h"
+#include "can_user.h"
+#include "diag.h"
+#include "stats.h"
+#include "load.h"
+#include "sched.h"
+#include "timer.h"
+#include "snap.h"
+
+
+// Pending request, written on Rx and taken by DIAG_Task()
+static volatile u8_t  DIAG_ReqPending;
+static volatile u8_t  DIAG_ReqBus;
+static volatile u8_t  DIAG_ReqSvc;
+static volatile u8_t  DIAG_ReqArg;
+static volatile u32_t  DIAG_ReqId;
+
+
+// Response in progress, sent one message per DIAG_Task() call
+typedef struct {
+
+	u8_t			Active;
+	u8_t			Bus;
+	u8_t			Svc;
+	u8_t			Arg;
+	
+	u32_t			Item;							// histogram or item index
+	u32_t			Sub;							// bucket or sub index
+	u32_t			Id;							// Id of a snapshot request
+	SNAP_Slot_t		Snap;							// slot being sent
+} DIAG_Dump_t;
+
+static DIAG_Dump_t  DIAG_Dump;
+
+
+#if DIAG_PERIOD_MS
+static u8_t  DIAG_PeriodicPending;
+#endif
+
+
+
+// DIAG_Request()
+// take a request received on DIAG_REQ_ID. Only stores it, so it is
+// safe on interrupt level. A request arriving during a response replaces
+// a pending one.
+void  DIAG_Request ( CANHandle_t  hBus, CANRxMsg_t  *pMsg)
+{
+	if ( pMsg->Len == 0)
+	{
+		return;
+	}
+	
+	DIAG_ReqBus = hBus;
+	DIAG_ReqSvc = pMsg->Data8[0];
+	DIAG_ReqArg = pMsg->Len > 1 ? pMsg->Data8[1] : 0xFF;
+	DIAG_ReqId  = DIAG_SNAP_ALL;
+	
+	if ( pMsg->Len >= 6)
+	{
+		DIAG_ReqId = pMsg->Data8[2] | pMsg->Data8[3] << 8 | pMsg->Data8[4] << 16 | ( u32_t) pMsg->Data8[5] << 24;
+	}
+	
+	DIAG_ReqPending = 1;
+}
+
+
+
+
+// DIAG_Send()
+// send a response message. Returns CAN_ERR_FAIL on a full Tx queue.
+static CANStatus_t  DIAG_Send ( u8_t  b0, u8_t  b1, u8_t  b2, u8_t  b3, u32_t  Value)
+{
+	CANMsg_t  Msg;
+	
+	
+	Msg.Id   = DIAG_RSP_ID;
+	Msg.Len  = 8;
+	Msg.Type = CAN_MSG_STANDARD;
+	
+	Msg.Data8[0] = b0;
+	Msg.Data8[1] = b1;
+	Msg.Data8[2] = b2;
+	Msg.Data8[3] = b3;
+	Msg.Data8[4] = Value;
+	Msg.Data8[5] = Value >> 8;
+	Msg.Data8[6] = Value >> 16;
+	Msg.Data8[7] = Value >> 24;
+	
+	return CAN_UserWrite ( DIAG_Dump.Bus, &Msg, CAN_USER_NO_DEADLINE);
+}
+
+
+
+
+// DIAG_NextHist()
+// send the next non-empty histogram bucket. Returns 0 when done.
+static u32_t  DIAG_NextHist ( void)
+{
+	DIAG_Dump_t  *pD;
+	u32_t  count;
+	
+	
+	pD = &DIAG_Dump;
+	
+	while ( pD->Item < STAT_HIST_COUNT)
+	{
+		if ( pD->Arg != 0xFF  &&  pD->Arg != pD->Item)
+		{
+			pD->Item++;
+			continue;
+		}
+		
+		while ( pD->Sub < STAT_BUCKETS)
+		{
+			count = STAT_Hist[pD->Item].Bucket[pD->Sub];
+			
+			if ( count != 0)
+			{
+				if ( DIAG_Send ( DIAG_RSP ( DIAG_SVC_HIST), pD->Item, pD->Sub, 0, count) != CAN_ERR_OK)
+				{
+					// Tx queue full, retry next call
+					return 1;
+				}
+				
+				pD->Sub++;
+				
+				return 1;
+			}
+			
+			pD->Sub++;
+		}
+		
+		pD->Sub = 0;
+		pD->Item++;
+	}
+	
+	// end marker
+	return DIAG_Send ( DIAG_RSP ( DIAG_SVC_HIST), DIAG_END, DIAG_END, 0, 0) != CAN_ERR_OK;
+}
+
+
+
+
+// DIAG_NextCounter()
+// send the next bus counter. Returns 0 when done.
+static u32_t  DIAG_NextCounter ( void)
+{
+	DIAG_Dump_t  *pD;
+	volatile u32_t  *pCnt;
+	
+	
+	pD = &DIAG_Dump;
+	
+	while ( pD->Item < 2)
+	{
+		if ( pD->Arg != 0xFF  &&  pD->Arg != pD->Item)
+		{
+			pD->Item++;
+			continue;
+		}
+		
+		if ( pD->Sub < STAT_CNT_COUNT)
+		{
+			pCnt = ( volatile u32_t *) &STAT_Bus[pD->Item];
+			
+			if ( DIAG_Send ( DIAG_RSP ( DIAG_SVC_COUNTERS), pD->Item, pD->Sub, 0, pCnt[pD->Sub]) == CAN_ERR_OK)
+			{
+				pD->Sub++;
+			}
+			
+			return 1;
+		}
+		
+		pD->Sub = 0;
+		pD->Item++;
+	}
+	
+	// end marker
+	return DIAG_Send ( DIAG_RSP ( DIAG_SVC_COUNTERS), DIAG_END, DIAG_END, 0, 0) != CAN_ERR_OK;
+}
+
+
+
+
+// DIAG_NextLoad()
+// send the next bus load. Returns 0 when done.
+static u32_t  DIAG_NextLoad ( void)
+{
+	DIAG_Dump_t  *pD;
+	
+	
+	pD = &DIAG_Dump;
+	
+	while ( pD->Item < 2)
+	{
+		if ( pD->Arg != 0xFF  &&  pD->Arg != pD->Item)
+		{
+			pD->Item++;
+			continue;
+		}
+		
+		if ( pD->Sub < LOAD_WIN_COUNT)
+		{
+			if ( DIAG_Send ( DIAG_RSP ( DIAG_SVC_LOAD), pD->Item, pD->Sub, 0, LOAD_Get ( pD->Item, pD->Sub)) == CAN_ERR_OK)
+			{
+				pD->Sub++;
+			}
+			
+			return 1;
+		}
+		
+		pD->Sub = 0;
+		pD->Item++;
+	}
+	
+	// end marker
+	return DIAG_Send ( DIAG_RSP ( DIAG_SVC_LOAD), DIAG_END, DIAG_END, 0, 0) != CAN_ERR_OK;
+}
+
+
+
+
+// DIAG_SnapNext()
+// next slot of a snapshot response, from Item on. Item is the bus for a
+// single Id and the slot index otherwise.
+static SNAP_Slot_t*  DIAG_SnapNext ( void)
+{
+	DIAG_Dump_t  *pD;
+	SNAP_Slot_t  *pS;
+	
+	
+	pD = &DIAG_Dump;
+	
+	if ( pD->Id != DIAG_SNAP_ALL)
+	{
+		for ( ; pD->Item < 2; pD->Item++)
+		{
+			if ( pD->Arg != 0xFF  &&  pD->Arg != pD->Item)
+			{
+				continue;
+			}
+			
+			pS = SNAP_Find ( pD->Item, pD->Id, pD->Id & DIAG_SNAP_EXT ? CAN_MSG_EXTENDED : CAN_MSG_STANDARD);
+			
+			if ( pS != NULL)
+			{
+				return pS;
+			}
+		}
+		
+		return NULL;
+	}
+	
+#if SNAP_SLOTS
+	for ( ; pD->Item < SNAP_SLOTS; pD->Item++)
+	{
+		pS = &SNAP_Slots[pD->Item];
+		
+		if ( pS->Key == SNAP_KEY_FREE)
+		{
+			continue;
+		}
+		
+		if ( pD->Arg == 0xFF  ||  pD->Arg == ( ( pS->Key >> 30) & 1))
+		{
+			return pS;
+		}
+	}
+#endif
+	
+	return NULL;
+}
+
+
+
+
+// DIAG_NextSnap()
+// send the next part of a stored message. Returns 0 when done.
+static u32_t  DIAG_NextSnap ( void)
+{
+	DIAG_Dump_t  *pD;
+	SNAP_Slot_t  *pS;
+	u32_t  value, lock;
+	
+	
+	pD = &DIAG_Dump;
+	
+	if ( pD->Sub == 0)
+	{
+		pS = DIAG_SnapNext();
+		
+		if ( pS == NULL)
+		{
+			// end marker
+			return DIAG_Send ( DIAG_RSP ( DIAG_SVC_SNAP), DIAG_END, DIAG_END, 0, SNAP_Lost) != CAN_ERR_OK;
+		}
+		
+		// the parts of one message must not tear
+		lock = CAN_UserLock();
+		pD->Snap = *pS;
+		CAN_UserUnlock ( lock);
+	}
+	
+	pS = &pD->Snap;
+	
+	switch ( pD->Sub)
+	{
+		case 0:
+			value = ( pS->Key & 0x1FFFFFFF) | ( pS->Key & ( CAN_MSG_EXTENDED << 28) ? DIAG_SNAP_EXT : 0);
+			break;
+		
+		case 1:
+			value = SNAP_COUNT ( pS->Info);
+			break;
+		
+		case 2:
+			value = TIMER_GetUs() - pS->Seen;
+			break;
+		
+		default:
+			value = pS->Data32[pD->Sub - 3];
+			break;
+	}
+	
+	if ( DIAG_Send ( DIAG_RSP ( DIAG_SVC_SNAP), ( pS->Key >> 30) & 1, pD->Sub, SNAP_LEN ( pS->Info), value) == CAN_ERR_OK)
+	{
+		pD->Sub++;
+		
+		if ( pD->Sub == DIAG_SNAP_PARTS)
+		{
+			pD->Sub = 0;
+			pD->Item++;
+		}
+	}
+	
+	return 1;
+}
+
+
+
+
+// DIAG_Start()
+// begin a response
+static void  DIAG_Start ( u8_t  hBus, u8_t  Svc, u8_t  Arg)
+{
+	DIAG_Dump.Active = 1;
+	DIAG_Dump.Bus    = hBus;
+	DIAG_Dump.Svc    = Svc;
+	DIAG_Dump.Arg    = Arg;
+	DIAG_Dump.Item   = 0;
+	DIAG_Dump.Sub    = 0;
+	DIAG_Dump.Id     = DIAG_SNAP_ALL;
+}
+
+
+
+
+// DIAG_Task()
+// scheduled every tick. Starts pending requests and the periodic dump
+// and sends at most one response message per call, so forwarding is
+// never held up for long.
+void  DIAG_Task ( void)
+{
+	u32_t  more, lock;
+	
+	
+	if ( !DIAG_Dump.Active)
+	{
+		if ( DIAG_ReqPending)
+		{
+			lock = CAN_UserLock();
+			DIAG_ReqPending = 0;
+			DIAG_Start ( DIAG_ReqBus, DIAG_ReqSvc, DIAG_ReqArg);
+			DIAG_Dump.Id = DIAG_ReqId;
+			CAN_UserUnlock ( lock);
+		}
+
+#if DIAG_PERIOD_MS
+		else if ( DIAG_PeriodicPending)
+		{
+			DIAG_PeriodicPending = 0;
+			DIAG_Start ( DIAG_PERIOD_BUS, DIAG_SVC_HIST, 0xFF);
+		}
+#endif
+		
+		else
+		{
+			return;
+		}
+	}
+	
+	// wait for the previous message, the response must not fill the
+	// spill area shared with the forwarded traffic
+	if ( CAN_UserTxStagedCount ( DIAG_Dump.Bus) > 0)
+	{
+		return;
+	}
+	
+	switch ( DIAG_Dump.Svc)
+	{
+		case DIAG_SVC_HIST:
+			more = DIAG_NextHist();
+			break;
+		
+		case DIAG_SVC_COUNTERS:
+			more = DIAG_NextCounter();
+			break;
+		
+		case DIAG_SVC_LOAD:
+			more = DIAG_NextLoad();
+			break;
+		
+		case DIAG_SVC_SNAP:
+			more = DIAG_NextSnap();
+			break;
+		
+		case DIAG_SVC_CLEAR:
+			if ( DIAG_Dump.Item == 0)
+			{
+				lock = CAN_UserLock();
+				STAT_Clear();
+				CAN_UserUnlock ( lock);
+				LOAD_ClearPeak();
+				DIAG_Dump.Item = 1;
+			}
+			
+			more = DIAG_Send ( DIAG_RSP ( DIAG_SVC_CLEAR), 0, 0, 0, 0) != CAN_ERR_OK;
+			break;
+		
+		default:
+			more = DIAG_Send ( DIAG_RSP_NEGATIVE, DIAG_Dump.Svc, 0, 0, 0) != CAN_ERR_OK;
+			break;
+	}
+	
+	DIAG_Dump.Active = more;
+}
+
+
+
+
+#if DIAG_PERIOD_MS
+// DIAG_Periodic()
+// scheduled every DIAG_PERIOD_MS, the dump itself starts in DIAG_Task()
+static void  DIAG_Periodic ( void)
+{
+	DIAG_PeriodicPending = 1;
+}
+#endif
+
+
+
+
+// DIAG_Init()
+// register the diag tasks with the scheduler
+void  DIAG_Init ( void)
+{
+	SCHED_Add ( DIAG_Task, 1, 1, 10);
+
+#if DIAG_PERIOD_MS
+	SCHED_Add ( DIAG_Periodic, DIAG_PERIOD_MS, DIAG_PERIOD_MS, DIAG_PERIOD_MS);
+#endif
+}
@@ -0,0 +1,102 @@
+
+#ifndef  _DIAG_H_
+#define  _DIAG_H_
+
+
+// Diagnostic Ids. Requests are taken from both busses, the response goes
+// to the bus the request came from.
+#ifndef  DIAG_REQ_ID
+#define  DIAG_REQ_ID			0x7F0
+#endif
+
+#ifndef  DIAG_RSP_ID
+#define  DIAG_RSP_ID			0x7F1
+#endif
+
+
+// Periodic dump of all histograms, 0 to dump on request only
+#ifndef  DIAG_PERIOD_MS
+#define  DIAG_PERIOD_MS		0
+#endif
+
+#ifndef  DIAG_PERIOD_BUS
+#define  DIAG_PERIOD_BUS		CAN_BUS1
+#endif
+
+
+// Services, byte 0 of a request. The response echoes the service with
+// bit 6 set, an unknown service is answered with DIAG_RSP_NEGATIVE.
+#define  DIAG_SVC_HIST			0x01		// byte 1: histogram or 0xFF for all
+#define  DIAG_SVC_COUNTERS		0x02		// byte 1: bus or 0xFF for both
+#define  DIAG_SVC_CLEAR			0x03		// clear histograms, counters and peak loads
+#define  DIAG_SVC_LOAD			0x04		// byte 1: bus or 0xFF for both
+#define  DIAG_SVC_SNAP			0x05		// byte 1: bus or 0xFF for both, byte 2..5: Id
+#define  DIAG_RSP_NEGATIVE		0x7F		// byte 1: rejected service
+
+#define  DIAG_RSP(svc)			( ( svc) | 0x40)
+
+#define  DIAG_END					0xFF		// item of the last message of a response
+
+
+// Histogram response, one message per non-empty bucket
+//	byte 0		DIAG_RSP ( DIAG_SVC_HIST)
+//	byte 1		histogram, see STAT_HIST_...
+//	byte 2		bucket
+//	byte 3		0
+//	byte 4..7	count, little endian
+// The response ends with histogram and bucket set to DIAG_END.
+
+
+// Counter response, one message per counter
+//	byte 0		DIAG_RSP ( DIAG_SVC_COUNTERS)
+//	byte 1		bus
+//	byte 2		counter, index into STAT_Bus_t: Rx, Forwarded, Filtered,
+//					Local, RxLost, TxRetry, TxDrop, ErrPassive, BusOff,
+//					RxHwm, TxHwm, Limited, Unchanged, Purged, OffMs, OffMaxMs,
+//					Expired, IsoTpSent, IsoTpAborted, J1939Sent, J1939Aborted,
+//					RtrAnswered
+//	byte 3		0
+//	byte 4..7	value, little endian
+// The response ends with bus and counter set to DIAG_END.
+
+
+// Clear response, a single message with byte 0 DIAG_RSP ( DIAG_SVC_CLEAR)
+
+
+// Load response, one message per window
+//	byte 0		DIAG_RSP ( DIAG_SVC_LOAD)
+//	byte 1		bus
+//	byte 2		window, see LOAD_WIN_...: 10 ms, 100 ms, 1 s, peak
+//	byte 3		0
+//	byte 4..7	load in permille, little endian
+// The response ends with bus and window set to DIAG_END.
+
+
+// Snapshot response, five messages per stored Id, see snap.h. Without
+// an Id in the request all Ids of the bus are sent in slot order. The
+// Id has bit 31 set for a 29 bit Id, in the request and the response.
+//	byte 0		DIAG_RSP ( DIAG_SVC_SNAP)
+//	byte 1		bus
+//	byte 2		part: 0 Id, 1 receive count, 2 age in us, 3 data
+//					bytes 0..3, 4 data bytes 4..7
+//	byte 3		length of the message
+//	byte 4..7	value, little endian
+// The response ends with bus and part set to DIAG_END, byte 4..7 hold
+// the Ids which found no slot. An Id not seen gets the end only.
+#define  DIAG_SNAP_PARTS			5
+#define  DIAG_SNAP_EXT				0x80000000
+#define  DIAG_SNAP_ALL				0xFFFFFFFF
+
+
+// diag function protos
+
+void  DIAG_Request ( CANHandle_t  hBus, CANRxMsg_t  *pMsg);
+
+
+void  DIAG_Task ( void);
+
+
+void  DIAG_Init ( void);
+
+
+#endif
@@ -0,0 +1,116 @@
+
+#include <stdio.h>
+
+#include "datatypes.h"
+#include "can.h"
+#include "bench.h"
+#include "sim.h"
+
+
+//
+// bench_decode [log]
+//
+// Prints the results of the cycle count benchmark, bench.c, from a
+// candump log or a PCAN-View trace file, stdin without a file name.
+// One table per run, cycles are PCLK cycles, ns at 60 MHz.
+//
+
+
+// PCLK in MHz, see timer.h
+#define  BENCH_PCLK_MHZ		60
+
+
+static const char  *BENCH_Names[BENCH_T_COUNT] = {
+
+	[BENCH_T_EMPTY]	= "timing overhead",
+	[BENCH_T_POLL]		= "CAN_UserPeek empty",
+	[BENCH_T_READ]		= "CAN_UserRead",
+	[BENCH_T_WRITE]	= "CAN_UserWrite",
+	[BENCH_T_COPY]		= "CAN_UserCopy",
+	[BENCH_T_LED]		= "HW_SetLED",
+	[BENCH_T_FORWARD]	= "Rx -> Tx forward",
+};
+
+
+
+// BENCH_U16()
+// little endian 16 bit value
+static u32_t  BENCH_U16 ( const u8_t  *p)
+{
+	return p[0] | p[1] << 8;
+}
+
+
+
+
+// BENCH_Print()
+// print a result message
+static void  BENCH_Print ( const CANMsg_t  *pMsg)
+{
+	static u32_t  last_cfg = 0x100;
+	const u8_t  *d = pMsg->Data8;
+	u32_t  cfg;
+
+
+	if ( pMsg->Len < 8)
+	{
+		return;
+	}
+
+	if ( d[0] == BENCH_END)
+	{
+		printf ( "\n");
+		last_cfg = 0x100;
+		return;
+	}
+
+	cfg = d[1];
+
+	if ( cfg != last_cfg)
+	{
+		printf ( "%s, MAMCR %u, MAMTIM %u\n", cfg & BENCH_CFG_THUMB ? "Thumb" : "ARM",
+				BENCH_CFG_MAMCR ( cfg), BENCH_CFG_MAMTIM ( cfg));
+		printf ( "  %-20s %8s %8s %8s %10s\n", "", "min", "mean", "max", "mean ns");
+
+		last_cfg = cfg;
+	}
+
+	printf ( "  %-20s %8u %8u %8u %10u\n", d[0] < BENCH_T_COUNT ? BENCH_Names[d[0]] : "?",
+			BENCH_U16 ( d + 2), BENCH_U16 ( d + 4), BENCH_U16 ( d + 6),
+			BENCH_U16 ( d + 4) * 1000 / BENCH_PCLK_MHZ);
+}
+
+
+
+
+int  main ( int  argc, char  **argv)
+{
+	char  line[256];
+	SIM_Frame_t  f;
+	FILE  *in;
+	double  t;
+
+
+	in = stdin;
+
+	if ( argc > 1)
+	{
+		in = fopen ( argv[1], "r");
+
+		if ( in == NULL)
+		{
+			perror ( argv[1]);
+			return 1;
+		}
+	}
+
+	while ( fgets ( line, sizeof ( line), in) != NULL)
+	{
+		if ( SIM_TraceLine ( line, &f, &t)  &&  f.Msg.Id == BENCH_ID  &&  !( f.Msg.Type & ( CAN_MSG_EXTENDED | CAN_MSG_RTR)))
+		{
+			BENCH_Print ( &f.Msg);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,1047 @@
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "datatypes.h"
+#include "can.h"
+#include "timer.h"
+#include "can_user.h"
+#include "sim.h"
+
+
+// transmit buffers per bus
+#define  CAN_SIM_TXBUF			3
+#define  CAN_SIM_WIRE_NONE		0				// nothing on the wire
+#define  CAN_SIM_WIRE_RX		0xFF			// the input frame is on the wire
+														// else Tx buffer + 1
+
+#define  CAN_SR_TBS(n)			( 1 << ( 2 + 8 * ( n)))
+
+
+// A simulated channel: the library queues and the controller
+typedef struct {
+
+	CANMsg_t		*pTxQueue;
+	u32_t			TxSize;
+	u32_t			TxIn, TxOut;
+
+	u8_t			*pRxQueue;
+	u32_t			RxSize;
+	u32_t			RxIn, RxOut;
+
+	void			(*Timestamp) ( CANRxMsg_t  *pMsg);
+	u32_t			(*RxCallback) ( void  *pMsg);
+	u32_t			(*TxError) ( void);
+	u8_t			*pInfo;
+
+	u32_t			Mode;							// BUS_ON or BUS_OFF
+	u32_t			BitNs;						// bit time
+
+	u32_t			BusOff;						// bus off, until RecoverEnd after a bus on
+	u64_t			RecoverEnd;					// end of the bus off recovery
+	u32_t			ErrIrq;						// Tx error interrupt pending
+
+	CANMsg_t		TxBuf[CAN_SIM_TXBUF];
+	u8_t			TxFull[CAN_SIM_TXBUF];
+	u64_t			TxReady[CAN_SIM_TXBUF];		// time the buffer was loaded
+	u32_t			TxIrq;
+
+	SIM_Frame_t		In;							// next input frame
+	u32_t			InValid;
+
+	u32_t			Wire;							// see CAN_SIM_WIRE_...
+	u64_t			WireEnd;						// end of the frame on the wire
+	u64_t			LastEnd;						// end of the previous frame
+
+	CANRxMsg_t		RxBuf;						// receive buffer
+	u32_t			RxFull;
+} CAN_Sim_t;
+
+static CAN_Sim_t  CAN_Sim[SIM_BUSSES];
+
+// Rx queues found empty since the last bus event, see CAN_SimNext()
+static u32_t  CAN_SimPolls[SIM_BUSSES];
+
+
+// Acceptance filter, counted in half words. Two 11 bit Ids share a
+// word, an extended range takes two.
+#define  CAN_SIM_AF_HALVES		1024
+
+typedef struct {
+
+	u8_t			Bus;
+	u8_t			Type;							// FILTER_...
+	u32_t			Start, End;
+} CAN_SimFilter_t;
+
+static CAN_SimFilter_t  CAN_SimFilter[CAN_SIM_AF_HALVES];
+static u32_t  CAN_SimFilterCount;
+static u32_t  CAN_SimFilterHalves;
+
+static const u8_t  CAN_SimFilterSize[4] = {
+
+	[FILTER_11BIT_ID]			= 1,
+	[FILTER_29BIT_ID]			= 2,
+	[FILTER_11BIT_ID_RANGE]	= 2,
+	[FILTER_29BIT_ID_RANGE]	= 4,
+};
+
+static u32_t  CAN_SimFilterMode = AF_ON_BYPASS_ON;
+
+
+static const u8_t  CAN_SimRxSource[SIM_BUSSES] = { CAN1_RX_INTSOURCE, CAN2_RX_INTSOURCE};
+static const u8_t  CAN_SimTxSource[SIM_BUSSES] = { CAN1_TX_INTSOURCE, CAN2_TX_INTSOURCE};
+
+
+
+// CAN_SimBus()
+// returns the channel of hBus or NULL
+static CAN_Sim_t*  CAN_SimBus ( CANHandle_t  hBus)
+{
+	if ( hBus >= SIM_BUSSES)
+	{
+		return NULL;
+	}
+
+	return &CAN_Sim[hBus];
+}
+
+
+
+
+// CAN_SimRxSlot()
+// Rx queue entry n, CANRxMsg_t with a timestamp handler, else CANMsg_t
+static void*  CAN_SimRxSlot ( CAN_Sim_t  *pC, u32_t  n)
+{
+	size_t  size;
+
+
+	size = pC->Timestamp != NULL ? sizeof ( CANRxMsg_t) : sizeof ( CANMsg_t);
+
+	return pC->pRxQueue + ( n % pC->RxSize) * size;
+}
+
+
+
+
+// CAN_SimKey()
+// arbitration key, lower wins
+static u32_t  CAN_SimKey ( const CANMsg_t  *pMsg)
+{
+	if ( pMsg->Type & CAN_MSG_EXTENDED)
+	{
+		return ( pMsg->Id >> 18) << 19 | 1 << 18 | ( pMsg->Id & 0x3FFFF);
+	}
+
+	return pMsg->Id << 19;
+}
+
+
+
+
+// CAN_SimFrameNs()
+// wire time of a message without stuff bits
+static u64_t  CAN_SimFrameNs ( CAN_Sim_t  *pC, const CANMsg_t  *pMsg)
+{
+	u32_t  bits;
+
+
+	bits = pMsg->Type & CAN_MSG_EXTENDED ? 67 : 47;
+
+	if ( !( pMsg->Type & CAN_MSG_RTR))
+	{
+		bits += 8 * ( pMsg->Len > 8 ? 8 : pMsg->Len);
+	}
+
+	return ( u64_t) bits * pC->BitNs;
+}
+
+
+
+
+// CAN_SimFilterMatch()
+// returns 1 if the acceptance filter passes the message
+static u32_t  CAN_SimFilterMatch ( CANHandle_t  hBus, const CANMsg_t  *pMsg)
+{
+	u32_t  i, ext;
+
+
+	if ( CAN_SimFilterMode != AF_ON)
+	{
+		return 1;
+	}
+
+	ext = ( pMsg->Type & CAN_MSG_EXTENDED) != 0;
+
+	for ( i = 0; i < CAN_SimFilterCount; i++)
+	{
+		CAN_SimFilter_t  *pF = &CAN_SimFilter[i];
+
+
+		if ( pF->Bus != hBus)
+		{
+			continue;
+		}
+
+		if ( ( pF->Type == FILTER_29BIT_ID  ||  pF->Type == FILTER_29BIT_ID_RANGE) != ext)
+		{
+			continue;
+		}
+
+		if ( pMsg->Id >= pF->Start  &&  pMsg->Id <= pF->End)
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+
+
+
+// CAN_SimFault()
+// returns 1 if the bus fault of SIM_Cfg covers hBus at Time
+static u32_t  CAN_SimFault ( CANHandle_t  hBus, u64_t  Time)
+{
+	return hBus == SIM_Cfg.FaultBus  &&  Time >= SIM_Cfg.FaultStartNs  &&  Time < SIM_Cfg.FaultEndNs;
+}
+
+
+
+
+// CAN_SimBusOn()
+// leave reset mode, after a bus off with the recovery sequence
+static void  CAN_SimBusOn ( CAN_Sim_t  *pC)
+{
+	if ( pC->BusOff)
+	{
+		pC->RecoverEnd = SIM_Now() + ( u64_t) 128 * 11 * pC->BitNs;
+	}
+
+	pC->Mode = BUS_ON;
+}
+
+
+
+
+// CAN_SimLoad()
+// Tx interrupt of the library: fill free transmit buffers from the queue
+static void  CAN_SimLoad ( CAN_Sim_t  *pC)
+{
+	u32_t  b;
+
+
+	for ( b = 0; b < CAN_SIM_TXBUF  &&  pC->TxOut != pC->TxIn; b++)
+	{
+		if ( pC->TxFull[b])
+		{
+			continue;
+		}
+
+		pC->TxBuf[b]   = pC->pTxQueue[pC->TxOut % pC->TxSize];
+		pC->TxFull[b]  = 1;
+		pC->TxReady[b] = SIM_Now();
+		pC->TxOut++;
+	}
+}
+
+
+
+
+// CAN_SimRxIsr()
+// Rx interrupt of the library: move the receive buffer to the Rx queue
+static void  CAN_SimRxIsr ( CANHandle_t  hBus, CAN_Sim_t  *pC)
+{
+	CANRxMsg_t  scratch;
+	CANMsg_t  *pMsg;
+	u32_t  full;
+
+
+	full = pC->pRxQueue == NULL  ||  pC->RxIn - pC->RxOut == pC->RxSize;
+
+	pMsg = full ? ( CANMsg_t *) &scratch : CAN_SimRxSlot ( pC, pC->RxIn);
+
+	if ( pC->Timestamp != NULL)
+	{
+		pC->Timestamp ( ( CANRxMsg_t *) pMsg);
+	}
+
+	pMsg->NetNr = hBus;
+	pMsg->Type  = pC->RxBuf.Type;
+	pMsg->Len   = pC->RxBuf.Len;
+	pMsg->Id    = pC->RxBuf.Id;
+	pMsg->Data32[0] = pC->RxBuf.Data32[0];
+	pMsg->Data32[1] = pC->RxBuf.Data32[1];
+
+	pC->RxFull = 0;
+
+	if ( full)
+	{
+		SIM_Bus[hBus].RxQueueFull++;
+		return;
+	}
+
+	if ( pC->RxCallback != NULL  &&  pC->RxCallback ( pMsg) == SKIP_MESSAGE)
+	{
+		return;
+	}
+
+	pC->RxIn++;
+}
+
+
+
+
+// CAN_SimFinish()
+// a frame left the wire
+static void  CAN_SimFinish ( CANHandle_t  hBus, CAN_Sim_t  *pC)
+{
+	SIM_Bus_t  *pS;
+	CANMsg_t  *pMsg;
+
+
+	pS = &SIM_Bus[hBus];
+
+	CAN_SimEvent();
+
+	if ( pC->Wire == CAN_SIM_WIRE_RX)
+	{
+		pMsg = &pC->In.Msg;
+		pC->InValid = 0;
+
+		pS->RxFrames++;
+		pS->BusyNs += CAN_SimFrameNs ( pC, pMsg);
+
+		if ( CAN_SimFault ( hBus, pC->WireEnd))
+		{
+			pS->RxFault++;
+			return;
+		}
+
+		if ( pC->Mode != BUS_ON)
+		{
+			return;
+		}
+
+		if ( !CAN_SimFilterMatch ( hBus, pMsg))
+		{
+			pS->RxFiltered++;
+		}
+
+		else if ( pC->RxFull)
+		{
+			pS->RxOverrun++;
+		}
+
+		else
+		{
+			memcpy ( &pC->RxBuf, pMsg, sizeof ( CANMsg_t));
+			pC->RxFull = 1;
+		}
+	}
+
+	else
+	{
+		pMsg = &pC->TxBuf[pC->Wire - 1];
+		pC->TxFull[pC->Wire - 1] = 0;
+		pC->TxIrq = 1;
+
+		pS->TxFrames++;
+		pS->BusyNs += CAN_SimFrameNs ( pC, pMsg);
+
+		if ( SIM_Cfg.TxHook != NULL)
+		{
+			SIM_Cfg.TxHook ( hBus, pMsg, pC->WireEnd);
+		}
+	}
+}
+
+
+
+
+// CAN_SimStep()
+// advance the wire of both busses to Now. The frame which is ready
+// first takes the idle bus, frames ready at the same time arbitrate by Id.
+void  CAN_SimStep ( u64_t  Now)
+{
+	CANHandle_t  hBus;
+
+
+	for ( hBus = 0; hBus < SIM_BUSSES; hBus++)
+	{
+		CAN_Sim_t  *pC = &CAN_Sim[hBus];
+
+
+		while ( 1)
+		{
+			u64_t  start, s;
+			u32_t  b, wire;
+
+
+			if ( pC->Wire != CAN_SIM_WIRE_NONE)
+			{
+				if ( Now < pC->WireEnd)
+				{
+					break;
+				}
+
+				CAN_SimFinish ( hBus, pC);
+
+				pC->LastEnd = pC->WireEnd;
+				pC->Wire    = CAN_SIM_WIRE_NONE;
+				continue;
+			}
+
+			wire  = CAN_SIM_WIRE_NONE;
+			start = 0;
+
+			if ( pC->InValid  &&  pC->In.TimeNs <= Now)
+			{
+				wire  = CAN_SIM_WIRE_RX;
+				start = pC->In.TimeNs > pC->LastEnd ? pC->In.TimeNs : pC->LastEnd;
+			}
+
+			// no transmit until the bus off recovery is done
+			for ( b = 0; b < CAN_SIM_TXBUF  &&  pC->Mode == BUS_ON  &&  pC->RecoverEnd <= Now; b++)
+			{
+				if ( !pC->TxFull[b])
+				{
+					continue;
+				}
+
+				s = pC->TxReady[b] > pC->LastEnd ? pC->TxReady[b] : pC->LastEnd;
+
+				if ( wire == CAN_SIM_WIRE_NONE  ||  s < start  ||
+						( s == start  &&  CAN_SimKey ( &pC->TxBuf[b]) < CAN_SimKey ( wire == CAN_SIM_WIRE_RX ? &pC->In.Msg : &pC->TxBuf[wire - 1])))
+				{
+					wire  = b + 1;
+					start = s;
+				}
+			}
+
+			if ( wire == CAN_SIM_WIRE_NONE)
+			{
+				break;
+			}
+
+			// a transmit on the faulty bus ends in bus off
+			if ( wire != CAN_SIM_WIRE_RX  &&  CAN_SimFault ( hBus, start))
+			{
+				pC->Mode   = BUS_OFF;
+				pC->BusOff = 1;
+				pC->ErrIrq = 1;
+
+				SIM_Bus[hBus].BusOff++;
+				CAN_SimEvent();
+				continue;
+			}
+
+			pC->Wire    = wire;
+			pC->WireEnd = start + CAN_SimFrameNs ( pC, wire == CAN_SIM_WIRE_RX ? &pC->In.Msg : &pC->TxBuf[wire - 1]);
+		}
+	}
+}
+
+
+
+
+// CAN_SimIrq()
+// run the pending and enabled CAN interrupts
+void  CAN_SimIrq ( void)
+{
+	CANHandle_t  hBus;
+
+
+	for ( hBus = 0; hBus < SIM_BUSSES; hBus++)
+	{
+		CAN_Sim_t  *pC = &CAN_Sim[hBus];
+
+
+		if ( pC->RxFull  &&  SIM_IrqEnabled ( CAN_SimRxSource[hBus]))
+		{
+			CAN_SimRxIsr ( hBus, pC);
+		}
+
+		if ( pC->TxIrq  &&  SIM_IrqEnabled ( CAN_SimTxSource[hBus]))
+		{
+			pC->TxIrq = 0;
+			CAN_SimLoad ( pC);
+		}
+
+		if ( pC->ErrIrq  &&  SIM_IrqEnabled ( GLOBAL_CAN_INTSOURCE))
+		{
+			pC->ErrIrq = 0;
+
+			if ( pC->TxError != NULL)
+			{
+				pC->TxError();
+			}
+
+			else
+			{
+				CAN_SimBusOn ( pC);
+			}
+		}
+	}
+}
+
+
+
+
+// CAN_SimIdle()
+// returns 1 when nothing is on the wire or waiting in a buffer or queue
+u32_t  CAN_SimIdle ( void)
+{
+	CANHandle_t  hBus;
+	u32_t  b;
+
+
+	for ( hBus = 0; hBus < SIM_BUSSES; hBus++)
+	{
+		CAN_Sim_t  *pC = &CAN_Sim[hBus];
+
+
+		if ( pC->InValid  ||  pC->Wire != CAN_SIM_WIRE_NONE  ||  pC->RxFull  ||
+				pC->TxIn != pC->TxOut  ||  pC->RxIn != pC->RxOut)
+		{
+			return 0;
+		}
+
+		for ( b = 0; b < CAN_SIM_TXBUF; b++)
+		{
+			if ( pC->TxFull[b])
+			{
+				return 0;
+			}
+		}
+	}
+
+	return 1;
+}
+
+
+
+
+// CAN_SimEvent()
+// something for the router to do, see CAN_SimNext()
+void  CAN_SimEvent ( void)
+{
+	memset ( CAN_SimPolls, 0, sizeof ( CAN_SimPolls));
+}
+
+
+
+
+// CAN_SimNext()
+// returns the time of the next bus event once the router waits for the
+// busses, else 0. The router waits when it found both Rx
+// queues empty twice, that is a whole pass of the main loop, since the
+// last frame left a wire or was written to a Tx queue. Returns ~0 when
+// the router waits and the busses are idle.
+u64_t  CAN_SimNext ( void)
+{
+	CANHandle_t  hBus;
+	u64_t  next;
+
+
+	next = ~0ULL;
+
+	for ( hBus = 0; hBus < SIM_BUSSES; hBus++)
+	{
+		CAN_Sim_t  *pC = &CAN_Sim[hBus];
+
+
+		if ( CAN_SimPolls[hBus] < 2  ||  pC->RxFull  ||  pC->TxIrq  ||  pC->ErrIrq)
+		{
+			return 0;
+		}
+
+		// end of a bus off recovery
+		if ( pC->RecoverEnd > SIM_Now()  &&  pC->RecoverEnd < next)
+		{
+			next = pC->RecoverEnd;
+		}
+
+		if ( pC->Wire != CAN_SIM_WIRE_NONE)
+		{
+			if ( pC->WireEnd < next)
+			{
+				next = pC->WireEnd;
+			}
+		}
+
+		// an input frame CAN_SimStep() puts on the wire at its time
+		else if ( pC->InValid  &&  pC->In.TimeNs < next)
+		{
+			next = pC->In.TimeNs;
+		}
+	}
+
+	return next;
+}
+
+
+
+
+// CAN_SimAccept()
+// take the next input frame of hBus. Returns 0 while the previous one
+// is still waiting for the wire.
+u32_t  CAN_SimAccept ( CANHandle_t  hBus, const SIM_Frame_t  *pFrame)
+{
+	CAN_Sim_t  *pC = &CAN_Sim[hBus];
+
+
+	if ( pC->InValid)
+	{
+		return 0;
+	}
+
+	pC->In      = *pFrame;
+	pC->InValid = 1;
+
+	return 1;
+}
+
+
+
+
+// CAN_SimSR()
+// status register: transmit buffer status bits
+u32_t  CAN_SimSR ( CANHandle_t  hBus)
+{
+	CAN_Sim_t  *pC = &CAN_Sim[hBus];
+	u32_t  sr, b;
+
+
+	sr = 0;
+
+	for ( b = 0; b < CAN_SIM_TXBUF; b++)
+	{
+		if ( !pC->TxFull[b])
+		{
+			sr |= CAN_SR_TBS ( b);
+		}
+	}
+
+	return sr;
+}
+
+
+
+
+// CAN_SimGSR()
+// global status register, bus off with the error counters at their
+// limits until the recovery is done
+u32_t  CAN_SimGSR ( CANHandle_t  hBus)
+{
+	CAN_Sim_t  *pC = &CAN_Sim[hBus];
+
+
+	if ( pC->BusOff  &&  ( pC->Mode != BUS_ON  ||  SIM_Now() < pC->RecoverEnd))
+	{
+		return 255U << 24 | CAN_GSR_BS | CAN_GSR_ES;
+	}
+
+	pC->BusOff = 0;
+
+	return 0;
+}
+
+
+
+
+// CAN_SimCommand()
+// command register: abort transmission of the selected buffers which are
+// not on the wire
+void  CAN_SimCommand ( CANHandle_t  hBus, u32_t  Cmr)
+{
+	CAN_Sim_t  *pC = &CAN_Sim[hBus];
+	u32_t  b;
+
+
+	if ( !( Cmr & 1 << 1))
+	{
+		return;
+	}
+
+	for ( b = 0; b < CAN_SIM_TXBUF; b++)
+	{
+		if ( ( Cmr & 1 << ( 5 + b))  &&  pC->TxFull[b]  &&  pC->Wire != b + 1)
+		{
+			pC->TxFull[b] = 0;
+			pC->TxIrq     = 1;
+		}
+	}
+}
+
+
+
+
+//
+// can.h API
+//
+
+
+CANStatus_t  CAN_ReferenceTxQueue ( CANHandle_t  hBus, CANMsg_t  *pQueueStart, u16_t  QueueSize)
+{
+	CAN_Sim_t  *pC = CAN_SimBus ( hBus);
+
+
+	if ( pC == NULL  ||  QueueSize == 0)
+	{
+		return CAN_ERR_FAIL;
+	}
+
+	pC->pTxQueue = pQueueStart;
+	pC->TxSize   = QueueSize;
+	pC->TxIn     = pC->TxOut = 0;
+
+	return CAN_ERR_OK;
+}
+
+
+CANStatus_t  CAN_ReferenceRxQueue ( CANHandle_t  hBus, void  *pQueueStart, u16_t  QueueSize)
+{
+	CAN_Sim_t  *pC = CAN_SimBus ( hBus);
+
+
+	if ( pC == NULL  ||  QueueSize == 0)
+	{
+		return CAN_ERR_FAIL;
+	}
+
+	pC->pRxQueue = pQueueStart;
+	pC->RxSize   = QueueSize;
+	pC->RxIn     = pC->RxOut = 0;
+
+	return CAN_ERR_OK;
+}
+
+
+void*  CAN_GetIsrVector ( u8_t  Number)
+{
+	return NULL;
+}
+
+
+CANStatus_t  CAN_SetTimestampHandler ( CANHandle_t  hBus, void ( *Handler)( CANRxMsg_t  *msg))
+{
+	CAN_Sim_t  *pC = CAN_SimBus ( hBus);
+
+
+	if ( pC == NULL)
+	{
+		return CAN_ERR_FAIL;
+	}
+
+	pC->Timestamp = Handler;
+
+	return CAN_ERR_OK;
+}
+
+
+CANStatus_t  CAN_SetAtomicHandler ( CANHandle_t  hBus, void ( *Handler)( void))
+{
+	return CAN_SimBus ( hBus) != NULL ? CAN_ERR_OK : CAN_ERR_FAIL;
+}
+
+
+CANStatus_t  CAN_SetUnatomicHandler ( CANHandle_t  hBus, void ( *Handler)( void))
+{
+	return CAN_SimBus ( hBus) != NULL ? CAN_ERR_OK : CAN_ERR_FAIL;
+}
+
+
+CANStatus_t  CAN_SetErrorLimit ( CANHandle_t  hBus, u8_t  NewLimit)
+{
+	return CAN_SimBus ( hBus) != NULL ? CAN_ERR_OK : CAN_ERR_FAIL;
+}
+
+
+CANStatus_t  CAN_SetTxErrorCallback ( CANHandle_t  hBus, u32_t ( *Handler)( void))
+{
+	CAN_Sim_t  *pC = CAN_SimBus ( hBus);
+
+
+	if ( pC == NULL)
+	{
+		return CAN_ERR_FAIL;
+	}
+
+	pC->TxError = Handler;
+
+	return CAN_ERR_OK;
+}
+
+
+CANStatus_t  CAN_SetRxCallback ( CANHandle_t  hBus, u32_t ( *Handler)( void*))
+{
+	CAN_Sim_t  *pC = CAN_SimBus ( hBus);
+
+
+	if ( pC == NULL)
+	{
+		return CAN_ERR_FAIL;
+	}
+
+	pC->RxCallback = Handler;
+
+	return CAN_ERR_OK;
+}
+
+
+CANStatus_t  CAN_SetChannelInfo ( CANHandle_t  hBus, u8_t  *NewInfo)
+{
+	CAN_Sim_t  *pC = CAN_SimBus ( hBus);
+
+
+	if ( pC == NULL)
+	{
+		return CAN_ERR_FAIL;
+	}
+
+	pC->pInfo = NewInfo;
+
+	return CAN_ERR_OK;
+}
+
+
+u8_t*  CAN_GetChannelInfo ( CANHandle_t  hBus)
+{
+	CAN_Sim_t  *pC = CAN_SimBus ( hBus);
+
+
+	return pC != NULL ? pC->pInfo : NULL;
+}
+
+
+CANStatus_t  CAN_SetBusMode ( CANHandle_t  hBus, u8_t  NewMode)
+{
+	CAN_Sim_t  *pC = CAN_SimBus ( hBus);
+
+
+	SIM_Preempt();
+
+	if ( pC == NULL)
+	{
+		return CAN_ERR_FAIL;
+	}
+
+	if ( NewMode == BUS_ON)
+	{
+		CAN_SimBusOn ( pC);
+	}
+
+	else
+	{
+		pC->Mode = NewMode;
+	}
+
+	return CAN_ERR_OK;
+}
+
+
+CANStatus_t  CAN_GetTransceiverType ( CANHandle_t  hBus, u8_t  *buff)
+{
+	if ( CAN_SimBus ( hBus) == NULL)
+	{
+		return CAN_ERR_FAIL;
+	}
+
+	*buff = CAN_TRANSCEIVER_TYPE_HS8;
+
+	return CAN_ERR_OK;
+}
+
+
+CANStatus_t  CAN_SetTransceiverMode ( CANHandle_t  hBus, u8_t  mode)
+{
+	return CAN_SimBus ( hBus) != NULL ? CAN_ERR_OK : CAN_ERR_FAIL;
+}
+
+
+CANStatus_t  CAN_GetLastIR ( CANHandle_t  hBus, u8_t  *pBuff)
+{
+	if ( CAN_SimBus ( hBus) == NULL)
+	{
+		return CAN_ERR_FAIL;
+	}
+
+	*pBuff = 0;
+
+	return CAN_ERR_OK;
+}
+
+
+CANMsg_t*  CAN_TxQueueGetNext ( CANHandle_t  hBus)
+{
+	CAN_Sim_t  *pC = CAN_SimBus ( hBus);
+
+
+	SIM_Preempt();
+
+	if ( pC == NULL  ||  pC->pTxQueue == NULL  ||  pC->TxIn - pC->TxOut == pC->TxSize)
+	{
+		return NULL;
+	}
+
+	return &pC->pTxQueue[pC->TxIn % pC->TxSize];
+}
+
+
+void*  CAN_RxQueueGetNext ( CANHandle_t  hBus)
+{
+	CAN_Sim_t  *pC = CAN_SimBus ( hBus);
+
+
+	SIM_Preempt();
+
+	if ( pC == NULL  ||  pC->RxIn == pC->RxOut)
+	{
+		if ( pC != NULL)
+		{
+			CAN_SimPolls[hBus]++;
+		}
+
+		return NULL;
+	}
+
+	return CAN_SimRxSlot ( pC, pC->RxOut);
+}
+
+
+CANStatus_t  CAN_TxQueueWriteNext ( CANHandle_t  hBus)
+{
+	CAN_Sim_t  *pC = CAN_SimBus ( hBus);
+
+
+	SIM_Preempt();
+
+	if ( pC == NULL  ||  pC->pTxQueue == NULL  ||  pC->TxIn - pC->TxOut == pC->TxSize)
+	{
+		return CAN_ERR_FAIL;
+	}
+
+	pC->TxIn++;
+
+	CAN_SimEvent();
+
+	// a free transmit buffer is loaded at once
+	CAN_SimLoad ( pC);
+
+	return CAN_ERR_OK;
+}
+
+
+CANStatus_t  CAN_RxQueueReadNext ( CANHandle_t  hBus)
+{
+	CAN_Sim_t  *pC = CAN_SimBus ( hBus);
+
+
+	SIM_Preempt();
+
+	if ( pC == NULL  ||  pC->RxIn == pC->RxOut)
+	{
+		return CAN_ERR_FAIL;
+	}
+
+	pC->RxOut++;
+
+	return CAN_ERR_OK;
+}
+
+
+CANStatus_t  CAN_InitChannel ( CANHandle_t  hBus, u32_t  Timing)
+{
+	CAN_Sim_t  *pC = CAN_SimBus ( hBus);
+	u32_t  brp, tseg1, tseg2;
+
+
+	if ( pC == NULL)
+	{
+		return CAN_ERR_FAIL;
+	}
+
+	brp   = ( Timing & 0x3FF) + 1;
+	tseg1 = ( ( Timing >> 16) & 0xF) + 1;
+	tseg2 = ( ( Timing >> 20) & 0x7) + 1;
+
+	pC->BitNs = ( u32_t) ( 1000000000ULL * brp * ( 1 + tseg1 + tseg2) / TIMER_PCLK);
+	pC->Mode  = BUS_OFF;
+	pC->Wire  = CAN_SIM_WIRE_NONE;
+
+	return CAN_ERR_OK;
+}
+
+
+CANStatus_t  CAN_ReInitChannel ( CANHandle_t  hBus)
+{
+	CAN_Sim_t  *pC = CAN_SimBus ( hBus);
+
+
+	if ( pC == NULL)
+	{
+		return CAN_ERR_FAIL;
+	}
+
+	memset ( pC->TxFull, 0, sizeof ( pC->TxFull));
+
+	pC->RxFull = 0;
+	pC->Mode   = BUS_OFF;
+
+	return CAN_ERR_OK;
+}
+
+
+CANStatus_t  CAN_InitFilters ( void)
+{
+	CAN_SimFilterCount  = 0;
+	CAN_SimFilterHalves = 0;
+
+	return CAN_ERR_OK;
+}
+
+
+CANStatus_t  CAN_SetFilterMode ( u8_t  NewMode)
+{
+	CAN_SimFilterMode = NewMode;
+
+	return CAN_ERR_OK;
+}
+
+
+CANStatus_t  CAN_FilterAddId ( CANHandle_t  hBus, u8_t  id_type, u32_t  IdStart, ...)
+{
+	CAN_SimFilter_t  *pF;
+	u32_t  end;
+	va_list  ap;
+
+
+	end = IdStart;
+
+	if ( id_type == FILTER_11BIT_ID_RANGE  ||  id_type == FILTER_29BIT_ID_RANGE)
+	{
+		va_start ( ap, IdStart);
+		end = va_arg ( ap, u32_t);
+		va_end ( ap);
+	}
+
+	if ( CAN_SimBus ( hBus) == NULL  ||  id_type > FILTER_29BIT_ID_RANGE  ||
+			CAN_SimFilterHalves + CAN_SimFilterSize[id_type] > CAN_SIM_AF_HALVES)
+	{
+		return CAN_ERR_FAIL;
+	}
+
+	pF = &CAN_SimFilter[CAN_SimFilterCount++];
+
+	pF->Bus   = hBus;
+	pF->Type  = id_type;
+	pF->Start = IdStart;
+	pF->End   = end;
+
+	CAN_SimFilterHalves += CAN_SimFilterSize[id_type];
+
+	return CAN_ERR_OK;
+}
@@ -0,0 +1,78 @@
+
+#include <stdlib.h>
+
+#include "datatypes.h"
+#include "can.h"
+#include "hardware.h"
+#include "sim.h"
+
+
+// LED colors and the number of color changes
+u8_t  HW_SimLED[HW_LED_CAN4b + 1];
+u32_t  HW_SimLEDChanges[HW_LED_CAN4b + 1];
+
+
+
+HWStatus_t  HW_Init ( void)
+{
+	return HW_ERR_OK;
+}
+
+
+HWStatus_t  HW_GetModuleID ( u8_t  *buffer)
+{
+	*buffer = 0;
+
+	return HW_ERR_OK;
+}
+
+
+HWStatus_t  HW_GetDIN ( u32_t  *buffer)
+{
+	*buffer = 0;
+
+	return HW_ERR_OK;
+}
+
+
+HWStatus_t  HW_SetDOUT ( u32_t  *buffer)
+{
+	return HW_ERR_OK;
+}
+
+
+HWStatus_t  HW_SetLED ( LEDHandle_t  hLED, LEDColor_t  color)
+{
+	SIM_Preempt();
+
+	if ( hLED > HW_LED_CAN4b  ||  color > HW_LED_ORANGE)
+	{
+		return HW_ERR_ILLPARAMVAL;
+	}
+
+	if ( HW_SimLED[hLED] != color)
+	{
+		HW_SimLED[hLED] = color;
+		HW_SimLEDChanges[hLED]++;
+	}
+
+	return HW_ERR_OK;
+}
+
+
+void  HW_JumpToBootloader ( u32_t  baudrate)
+{
+	exit ( 1);
+}
+
+
+HWStatus_t  HW_SetBeeper ( u8_t  tone)
+{
+	return HW_ERR_OK;
+}
+
+
+void  HW_SwitchOFF ( void)
+{
+	exit ( 0);
+}
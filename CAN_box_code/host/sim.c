@@ -0,0 +1,447 @@
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "datatypes.h"
+#include "can.h"
+#include "timer.h"
+#include "sim.h"
+
+
+// Configuration and counters
+SIM_Cfg_t  SIM_Cfg = {
+
+	.Clock   = SIM_CLOCK_VIRTUAL,
+	.StepNs  = 250,
+	.QuietUs = 100000,
+	
+	.FaultBus = SIM_BUSSES,
+};
+
+SIM_Bus_t  SIM_Bus[SIM_BUSSES];
+
+
+// plain registers
+volatile unsigned long  SIM_VICVectAddrN[16];
+volatile unsigned long  SIM_VICVectCntlN[16];
+volatile unsigned long  SIM_VICVectAddr;
+volatile unsigned long  SIM_T1TCR, SIM_T1PR, SIM_T1MCR, SIM_T1IR;
+volatile unsigned long  SIM_T0TCR, SIM_T0PR, SIM_T0MR0, SIM_T0MCR, SIM_T0IR;
+volatile unsigned char  SIM_MAMCR = 2, SIM_MAMTIM = 3;			// set by crt0.S
+
+
+// registers with side effects, the last one handed out by SIM_Reg()
+static volatile unsigned long  SIM_RegSlot[SIM_REG_COUNT];
+static s32_t  SIM_RegPending = -1;
+
+static u32_t  SIM_VicMask;					// enabled interrupt sources
+static u32_t  SIM_InIrq;
+
+
+// Timer0, match 0 with interrupt and reset
+#define  SIM_T0_INTSOURCE		4
+
+static u64_t  SIM_T0Next;					// next match, 0 while stopped
+static u32_t  SIM_T0Irq;
+
+
+// clock
+static u64_t  SIM_Clock;
+static u64_t  SIM_RealStart;
+static u64_t  SIM_LastActive;
+
+// host time spent in the simulation, see SIM_HostTime()
+static u64_t  SIM_HostSim;
+static u64_t  SIM_HostEnter;
+static u32_t  SIM_HostIn;
+
+
+// input ring, filled by the feeder thread
+#define  SIM_RING_SIZE		256
+
+static SIM_Frame_t  SIM_Ring[SIM_RING_SIZE];
+static u32_t  SIM_RingIn, SIM_RingOut;
+static u32_t  SIM_RingEnd;
+
+static pthread_mutex_t  SIM_RingLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  SIM_RingCond = PTHREAD_COND_INITIALIZER;
+
+
+
+// SIM_HostNs()
+// monotonic host clock
+static u64_t  SIM_HostNs ( void)
+{
+	struct timespec  ts;
+
+
+	clock_gettime ( CLOCK_MONOTONIC, &ts);
+
+	return ( u64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+
+
+// SIM_Now()
+// simulation time in ns
+u64_t  SIM_Now ( void)
+{
+	return SIM_Clock;
+}
+
+
+
+
+// SIM_Put()
+// queue an input frame, blocks while the ring is full. Called by the
+// feeder thread.
+void  SIM_Put ( const SIM_Frame_t  *pFrame)
+{
+	pthread_mutex_lock ( &SIM_RingLock);
+
+	while ( SIM_RingIn - SIM_RingOut == SIM_RING_SIZE)
+	{
+		pthread_cond_wait ( &SIM_RingCond, &SIM_RingLock);
+	}
+
+	SIM_Ring[SIM_RingIn % SIM_RING_SIZE] = *pFrame;
+	SIM_RingIn++;
+
+	pthread_cond_broadcast ( &SIM_RingCond);
+	pthread_mutex_unlock ( &SIM_RingLock);
+}
+
+
+
+
+// SIM_PutEnd()
+// mark the end of the input
+void  SIM_PutEnd ( void)
+{
+	pthread_mutex_lock ( &SIM_RingLock);
+
+	SIM_RingEnd = 1;
+
+	pthread_cond_broadcast ( &SIM_RingCond);
+	pthread_mutex_unlock ( &SIM_RingLock);
+}
+
+
+
+
+// SIM_Feed()
+// hand input frames to the busses. With the virtual clock an empty ring
+// stops the clock until the feeder catches up. Returns 1 at the end of
+// the input.
+static u32_t  SIM_Feed ( void)
+{
+	u32_t  end;
+
+
+	pthread_mutex_lock ( &SIM_RingLock);
+
+	while ( SIM_Cfg.Clock == SIM_CLOCK_VIRTUAL  &&  SIM_RingIn == SIM_RingOut  &&  !SIM_RingEnd)
+	{
+		pthread_cond_wait ( &SIM_RingCond, &SIM_RingLock);
+	}
+
+	while ( SIM_RingIn != SIM_RingOut)
+	{
+		SIM_Frame_t  *pF;
+
+
+		pF = &SIM_Ring[SIM_RingOut % SIM_RING_SIZE];
+
+		if ( pF->Bus >= SIM_BUSSES)
+		{
+			SIM_RingOut++;
+			continue;
+		}
+
+		if ( !CAN_SimAccept ( pF->Bus, pF))
+		{
+			break;
+		}
+
+		SIM_RingOut++;
+		SIM_LastActive = SIM_Clock;
+
+		pthread_cond_broadcast ( &SIM_RingCond);
+	}
+
+	end = SIM_RingEnd  &&  SIM_RingIn == SIM_RingOut;
+
+	pthread_mutex_unlock ( &SIM_RingLock);
+
+	return end;
+}
+
+
+
+
+// SIM_RegFold()
+// apply the side effect of the last register access
+static void  SIM_RegFold ( void)
+{
+	switch ( SIM_RegPending)
+	{
+		case SIM_REG_VIC_ENABLE:
+			SIM_VicMask |= SIM_RegSlot[SIM_REG_VIC_ENABLE];
+			break;
+
+		case SIM_REG_VIC_ENCLR:
+			SIM_VicMask &= ~SIM_RegSlot[SIM_REG_VIC_ENCLR];
+			break;
+
+		case SIM_REG_C1CMR:
+			CAN_SimCommand ( CAN_BUS1, SIM_RegSlot[SIM_REG_C1CMR]);
+			break;
+
+		case SIM_REG_C2CMR:
+			CAN_SimCommand ( CAN_BUS2, SIM_RegSlot[SIM_REG_C2CMR]);
+			break;
+
+		default:
+			break;
+	}
+
+	SIM_RegPending = -1;
+}
+
+
+
+
+// SIM_T0Step()
+// advance Timer0 to the clock
+static void  SIM_T0Step ( void)
+{
+	u64_t  period;
+
+
+	if ( !( SIM_T0TCR & 1)  ||  !( SIM_T0MCR & 1))
+	{
+		SIM_T0Next = 0;
+		return;
+	}
+
+	period = ( u64_t) ( SIM_T0PR + 1) * ( SIM_T0MR0 + 1) * 1000000000ULL / TIMER_PCLK;
+
+	if ( SIM_T0Next == 0)
+	{
+		SIM_T0Next = SIM_Clock + period;
+	}
+
+	while ( SIM_Clock >= SIM_T0Next)
+	{
+		SIM_T0Irq   = 1;
+		SIM_T0Next += period;
+	}
+}
+
+
+
+
+// SIM_T0Isr()
+// call the Timer0 handler of the VIC. The host build is linked without
+// PIE, so the handler address fits the register.
+static void  SIM_T0Isr ( void)
+{
+	u32_t  s;
+
+
+	if ( !SIM_T0Irq  ||  !( SIM_VicMask & ( 1 << SIM_T0_INTSOURCE)))
+	{
+		return;
+	}
+
+	for ( s = 0; s < 16; s++)
+	{
+		if ( SIM_VICVectCntlN[s] == ( 1 << 5 | SIM_T0_INTSOURCE))
+		{
+			SIM_T0Irq = 0;
+			CAN_SimEvent();
+
+			( ( void ( *) ( void)) ( unsigned long) SIM_VICVectAddrN[s]) ();
+			return;
+		}
+	}
+}
+
+
+
+
+// SIM_Preempt()
+// preemption point: advance the clock and the busses, run pending
+// interrupts and end the run when all is quiet
+void  SIM_Preempt ( void)
+{
+	u32_t  end;
+
+
+	SIM_RegFold();
+
+	if ( SIM_InIrq)
+	{
+		return;
+	}
+
+	SIM_HostEnter = SIM_HostNs();
+	SIM_HostIn    = 1;
+
+	if ( SIM_Cfg.Clock == SIM_CLOCK_REAL)
+	{
+		SIM_Clock = SIM_HostEnter - SIM_RealStart;
+	}
+
+	else
+	{
+		SIM_Clock += SIM_Cfg.StepNs;
+	}
+
+	end = SIM_Feed();
+
+	if ( SIM_Cfg.Clock == SIM_CLOCK_VIRTUAL)
+	{
+		u64_t  next = CAN_SimNext();
+
+
+		// idle wires at the end of the input: the run is over
+		if ( next == ~0ULL)
+		{
+			next = end ? SIM_LastActive + ( u64_t) SIM_Cfg.QuietUs * 1000 : 0;
+		}
+
+		if ( SIM_T0Next != 0  &&  next > SIM_T0Next)
+		{
+			next = SIM_T0Next;
+		}
+
+		if ( next > SIM_Clock)
+		{
+			SIM_Clock = next;
+		}
+	}
+
+	CAN_SimStep ( SIM_Clock);
+	SIM_T0Step();
+
+	// the interrupt handlers count as router time
+	SIM_HostSim += SIM_HostNs() - SIM_HostEnter;
+
+	SIM_InIrq = 1;
+	CAN_SimIrq();
+	SIM_T0Isr();
+	SIM_InIrq = 0;
+
+	SIM_HostEnter = SIM_HostNs();
+
+	if ( !CAN_SimIdle())
+	{
+		SIM_LastActive = SIM_Clock;
+	}
+
+	else if ( end  &&  SIM_Clock - SIM_LastActive >= ( u64_t) SIM_Cfg.QuietUs * 1000)
+	{
+		if ( SIM_Cfg.EndHook != NULL)
+		{
+			SIM_Cfg.EndHook();
+		}
+
+		exit ( 0);
+	}
+
+	SIM_HostSim += SIM_HostNs() - SIM_HostEnter;
+	SIM_HostIn   = 0;
+}
+
+
+
+
+// SIM_Reg()
+// returns the register Reg, loaded with its current value. Interrupts
+// run before the access, a write to it is applied later by SIM_RegFold().
+volatile unsigned long*  SIM_Reg ( unsigned int  Reg)
+{
+	SIM_Preempt();
+	SIM_RegFold();
+
+	switch ( Reg)
+	{
+		case SIM_REG_VIC_ENABLE:
+			SIM_RegSlot[Reg] = SIM_VicMask;
+			break;
+
+		case SIM_REG_VIC_ENCLR:
+		case SIM_REG_C1CMR:
+		case SIM_REG_C2CMR:
+			SIM_RegSlot[Reg] = 0;
+			break;
+
+		case SIM_REG_T1TC:
+			SIM_RegSlot[Reg] = ( u32_t) ( SIM_Clock / 1000);
+			break;
+
+		case SIM_REG_C1SR:
+			SIM_RegSlot[Reg] = CAN_SimSR ( CAN_BUS1);
+			break;
+
+		case SIM_REG_C2SR:
+			SIM_RegSlot[Reg] = CAN_SimSR ( CAN_BUS2);
+			break;
+
+		case SIM_REG_C1GSR:
+			SIM_RegSlot[Reg] = CAN_SimGSR ( CAN_BUS1);
+			break;
+
+		case SIM_REG_C2GSR:
+			SIM_RegSlot[Reg] = CAN_SimGSR ( CAN_BUS2);
+			break;
+	}
+
+	SIM_RegPending = Reg;
+
+	return &SIM_RegSlot[Reg];
+}
+
+
+
+
+// SIM_IrqEnabled()
+// returns non zero if the interrupt source is enabled in the VIC
+u32_t  SIM_IrqEnabled ( u32_t  Source)
+{
+	SIM_RegFold();
+
+	return SIM_VicMask & ( 1 << Source);
+}
+
+
+
+
+// SIM_HostTime()
+// host time since SIM_Start() and the part of it spent in the
+// simulation. The rest went to the router, the interrupt handlers and
+// the library calls.
+void  SIM_HostTime ( u64_t  *pTotalNs, u64_t  *pSimNs)
+{
+	u64_t  now;
+
+
+	now       = SIM_HostNs();
+	*pTotalNs = now - SIM_RealStart;
+	*pSimNs   = SIM_HostSim + ( SIM_HostIn ? now - SIM_HostEnter : 0);
+}
+
+
+
+
+// SIM_Start()
+// start the clock, call before router_main()
+void  SIM_Start ( void)
+{
+	SIM_RealStart  = SIM_HostNs();
+	SIM_Clock      = 0;
+	SIM_LastActive = 0;
+}
@@ -0,0 +1,160 @@
+
+#ifndef  _SIM_H_
+#define  _SIM_H_
+
+
+//
+// Host simulation of the PCAN-Router. The router sources are built for
+// Linux against a software implementation of can.h and hardware.h. The
+// LPC21xx registers they touch are mapped by sim_lpc21xx.h.
+//
+// There is one simulated CPU, the thread running router_main(). Every
+// library call and every access to a register with side effects is a
+// preemption point. There the simulation advances the clock and the
+// busses and runs the interrupts which are pending and enabled in the
+// VIC, like the ARM7 does between two instructions. Interrupts don't
+// nest. Input frames come from a feeder thread through SIM_Put().
+//
+// With the virtual clock the time the router spends waiting for the
+// busses is skipped, the clock jumps to the next frame leaving a wire or
+// the next Timer0 match. Work which the router starts on its own,
+// without a frame or a timer interrupt, must be made an event of
+// CAN_SimNext() or it runs late.
+//
+// Each bus has three transmit buffers, arbitrated by Id, and a single
+// receive buffer. A frame arriving while the receive buffer is still
+// full is lost as a data overrun. Frame times follow the bit timing set
+// with CAN_InitChannel(), stuff bits are not modelled.
+//
+// A bus fault, see SIM_Cfg_t, takes a bus off at the first transmit
+// while it lasts and loses the frames arriving meanwhile. The bus off
+// raises the Tx error callback, without one the bus goes on at once
+// like in the library. After a bus on the controller waits 128 * 11
+// bit times before it sends.
+//
+
+
+// defines
+#define  SIM_BUSSES				2
+
+#define  SIM_CLOCK_VIRTUAL		0			// clock advances SIM_Cfg.StepNs per preemption point
+											// and skips idle time
+#define  SIM_CLOCK_REAL			1			// clock follows the host clock
+
+#define  SIM_GEN_LOAD			0			// synthetic profiles, see SIM_Gen()
+#define  SIM_GEN_DIAG			1
+
+
+// An input frame. Frames are put in time order, a frame with a time
+// before the end of the previous frame on its bus follows it back to
+// back, so time 0 saturates the bus.
+typedef struct {
+
+	u64_t			TimeNs;						// arrival of the start of frame
+	u8_t			Bus;							// CAN_BUSx
+	CANMsg_t		Msg;
+} SIM_Frame_t;
+
+
+// Configuration, set before SIM_Start()
+typedef struct {
+
+	u32_t			Clock;						// see SIM_CLOCK_...
+	u32_t			StepNs;						// virtual clock per preemption point
+	u32_t			QuietUs;						// end of run after input end and this idle time
+	
+	u32_t			FaultBus;					// bus with a fault or SIM_BUSSES for none
+	u64_t			FaultStartNs;				// fault from
+	u64_t			FaultEndNs;					// fault until
+	
+	void			(*TxHook) ( CANHandle_t  hBus, const CANMsg_t  *pMsg, u64_t  TimeNs);
+	void			(*EndHook) ( void);
+} SIM_Cfg_t;
+
+extern SIM_Cfg_t  SIM_Cfg;
+
+
+// Simulation counters per bus
+typedef struct {
+
+	u32_t			RxFrames;					// frames arrived on the wire
+	u32_t			RxFiltered;					// rejected by the acceptance filter
+	u32_t			RxOverrun;					// lost, receive buffer still full
+	u32_t			RxQueueFull;				// lost, library Rx queue full
+	u32_t			TxFrames;					// frames sent on the wire
+	u32_t			RxFault;						// lost to the bus fault
+	u32_t			BusOff;						// bus off events
+	u64_t			BusyNs;						// wire time of all frames
+} SIM_Bus_t;
+
+extern SIM_Bus_t  SIM_Bus[SIM_BUSSES];
+
+
+// hardware_sim.c, indexed by HW_LED_...
+extern u8_t  HW_SimLED[];
+extern u32_t  HW_SimLEDChanges[];
+
+
+// sim.c
+
+u64_t  SIM_Now ( void);
+
+
+void  SIM_Preempt ( void);
+
+
+void  SIM_Put ( const SIM_Frame_t  *pFrame);
+
+
+void  SIM_PutEnd ( void);
+
+
+void  SIM_Start ( void);
+
+
+u32_t  SIM_IrqEnabled ( u32_t  Source);
+
+
+void  SIM_HostTime ( u64_t  *pTotalNs, u64_t  *pSimNs);
+
+
+// sim_trace.c
+
+extern u32_t  SIM_TraceBus;
+
+
+u32_t  SIM_TraceLine ( const char  *pLine, SIM_Frame_t  *pF, double  *pTime);
+
+
+// sim_gen.c
+
+void  SIM_Gen ( u32_t  Profile, u32_t  Frames);
+
+
+// can_sim.c, called by sim.c
+
+void  CAN_SimStep ( u64_t  Now);
+
+
+void  CAN_SimIrq ( void);
+
+
+u32_t  CAN_SimIdle ( void);
+
+
+u64_t  CAN_SimNext ( void);
+
+
+void  CAN_SimCommand ( CANHandle_t  hBus, u32_t  Cmr);
+
+
+u32_t  CAN_SimAccept ( CANHandle_t  hBus, const SIM_Frame_t  *pFrame);
+
+
+u32_t  CAN_SimSR ( CANHandle_t  hBus);
+
+
+u32_t  CAN_SimGSR ( CANHandle_t  hBus);
+
+
+#endif
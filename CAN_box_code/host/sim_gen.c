@@ -0,0 +1,155 @@
+
+#include <string.h>
+
+#include "datatypes.h"
+#include "can.h"
+#include "diag.h"
+#include "sim.h"
+
+
+// nominal bit time of the generated load, 500 kbit/s
+#define  SIM_GEN_BIT_NS		2000
+
+
+
+// SIM_GenRand()
+// pseudo random numbers, the same sequence on every run
+static u32_t  SIM_GenRand ( void)
+{
+	static u32_t  x = 2463534242UL;
+
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+
+	return x;
+}
+
+
+
+
+// SIM_GenFrameNs()
+// nominal wire time of a message at 500 kbit/s without stuff bits
+static u64_t  SIM_GenFrameNs ( const CANMsg_t  *pMsg)
+{
+	u32_t  bits;
+
+
+	bits = pMsg->Type & CAN_MSG_EXTENDED ? 67 : 47;
+
+	if ( !( pMsg->Type & CAN_MSG_RTR))
+	{
+		bits += 8 * pMsg->Len;
+	}
+
+	return ( u64_t) bits * SIM_GEN_BIT_NS;
+}
+
+
+
+
+// SIM_GenTraffic()
+// a random message, one in eight is extended. Ids of the diagnostic
+// service are left out.
+static void  SIM_GenTraffic ( CANMsg_t  *pMsg)
+{
+	u32_t  i, r;
+
+
+	r = SIM_GenRand();
+
+	if ( ( r & 7) == 0)
+	{
+		pMsg->Id   = SIM_GenRand() & 0x1FFFFFFF;
+		pMsg->Type = CAN_MSG_EXTENDED;
+	}
+
+	else
+	{
+		pMsg->Id   = ( r >> 3) % DIAG_REQ_ID;
+		pMsg->Type = CAN_MSG_STANDARD;
+	}
+
+	pMsg->Len = ( r >> 16) % 9;
+
+	for ( i = 0; i < pMsg->Len; i++)
+	{
+		pMsg->Data8[i] = SIM_GenRand();
+	}
+}
+
+
+
+
+// SIM_Gen()
+// put Frames frames of a synthetic profile per bus
+//		SIM_GEN_LOAD	both busses at 100 % load
+//		SIM_GEN_DIAG	both busses at 30 % load, every 20 ms a burst of
+//							8 diagnostic requests on CAN1
+void  SIM_Gen ( u32_t  Profile, u32_t  Frames)
+{
+	u64_t  next[SIM_BUSSES], burst;
+	u32_t  count[SIM_BUSSES], load, pending, b;
+	SIM_Frame_t  f;
+
+
+	load    = Profile == SIM_GEN_LOAD ? 100 : 30;
+	burst   = 0;
+	pending = 0;
+
+	for ( b = 0; b < SIM_BUSSES; b++)
+	{
+		next[b]  = 0;
+		count[b] = 0;
+	}
+
+	for ( ;;)
+	{
+		b = next[CAN_BUS1] <= next[CAN_BUS2] ? CAN_BUS1 : CAN_BUS2;
+
+		if ( count[b] == Frames)
+		{
+			b ^= 1;
+
+			if ( count[b] == Frames)
+			{
+				break;
+			}
+		}
+
+		memset ( &f, 0, sizeof ( f));
+
+		f.TimeNs = next[b];
+		f.Bus    = b;
+
+		if ( Profile == SIM_GEN_DIAG  &&  b == CAN_BUS1  &&  next[b] >= burst)
+		{
+			pending = 8;
+			burst  += 20000000;
+		}
+
+		if ( pending > 0  &&  b == CAN_BUS1)
+		{
+			// the requests follow each other back to back
+			f.Msg.Id       = DIAG_REQ_ID;
+			f.Msg.Type     = CAN_MSG_STANDARD;
+			f.Msg.Len      = 2;
+			f.Msg.Data8[0] = pending & 1 ? DIAG_SVC_HIST : DIAG_SVC_COUNTERS;
+			f.Msg.Data8[1] = 0xFF;
+
+			SIM_Put ( &f);
+
+			next[b] += SIM_GenFrameNs ( &f.Msg);
+			pending--;
+			continue;
+		}
+
+		SIM_GenTraffic ( &f.Msg);
+
+		SIM_Put ( &f);
+
+		next[b] += SIM_GenFrameNs ( &f.Msg) * 100 / load;
+		count[b]++;
+	}
+}
@@ -0,0 +1,88 @@
+
+#ifndef  __LPC21xx_H
+#define  __LPC21xx_H
+
+
+//
+// LPC21xx registers of the host build, force included before every
+// source so the target lpc21xx.h is skipped. Registers with side effects
+// go through SIM_Reg(), which is a preemption point. Writes to them take
+// effect at the next register access or library call. The others are
+// plain variables, defined in sim.c.
+//
+
+
+// registers with side effects
+#define  SIM_REG_VIC_ENABLE		0
+#define  SIM_REG_VIC_ENCLR		1
+#define  SIM_REG_T1TC				2
+#define  SIM_REG_C1SR				3
+#define  SIM_REG_C2SR				4
+#define  SIM_REG_C1GSR			5
+#define  SIM_REG_C2GSR			6
+#define  SIM_REG_C1CMR			7
+#define  SIM_REG_C2CMR			8
+#define  SIM_REG_COUNT			9
+
+volatile unsigned long*  SIM_Reg ( unsigned int  Reg);
+
+#define  VICIntEnable		( *SIM_Reg ( SIM_REG_VIC_ENABLE))
+#define  VICIntEnClr			( *SIM_Reg ( SIM_REG_VIC_ENCLR))
+#define  T1TC					( *SIM_Reg ( SIM_REG_T1TC))
+#define  C1SR					( *SIM_Reg ( SIM_REG_C1SR))
+#define  C2SR					( *SIM_Reg ( SIM_REG_C2SR))
+#define  C1GSR					( *SIM_Reg ( SIM_REG_C1GSR))
+#define  C2GSR					( *SIM_Reg ( SIM_REG_C2GSR))
+#define  C1CMR					( *SIM_Reg ( SIM_REG_C1CMR))
+#define  C2CMR					( *SIM_Reg ( SIM_REG_C2CMR))
+
+
+// plain registers
+extern volatile unsigned long  SIM_VICVectAddrN[16];
+extern volatile unsigned long  SIM_VICVectCntlN[16];
+extern volatile unsigned long  SIM_VICVectAddr;
+extern volatile unsigned long  SIM_T1TCR, SIM_T1PR, SIM_T1MCR, SIM_T1IR;
+extern volatile unsigned long  SIM_T0TCR, SIM_T0PR, SIM_T0MR0, SIM_T0MCR, SIM_T0IR;
+extern volatile unsigned char  SIM_MAMCR, SIM_MAMTIM;
+
+#define  VICVectAddr			SIM_VICVectAddr
+#define  VICVectAddr0		SIM_VICVectAddrN[0]
+#define  VICVectAddr1		SIM_VICVectAddrN[1]
+#define  VICVectAddr2		SIM_VICVectAddrN[2]
+#define  VICVectAddr3		SIM_VICVectAddrN[3]
+#define  VICVectAddr4		SIM_VICVectAddrN[4]
+#define  VICVectAddr5		SIM_VICVectAddrN[5]
+#define  VICVectAddr6		SIM_VICVectAddrN[6]
+#define  VICVectAddr7		SIM_VICVectAddrN[7]
+#define  VICVectCntl0		SIM_VICVectCntlN[0]
+#define  VICVectCntl1		SIM_VICVectCntlN[1]
+#define  VICVectCntl2		SIM_VICVectCntlN[2]
+#define  VICVectCntl3		SIM_VICVectCntlN[3]
+#define  VICVectCntl4		SIM_VICVectCntlN[4]
+#define  VICVectCntl5		SIM_VICVectCntlN[5]
+#define  VICVectCntl6		SIM_VICVectCntlN[6]
+#define  VICVectCntl7		SIM_VICVectCntlN[7]
+
+#define  T1TCR					SIM_T1TCR
+#define  T1PR					SIM_T1PR
+#define  T1MCR					SIM_T1MCR
+#define  T1IR					SIM_T1IR
+
+#define  T0TCR					SIM_T0TCR
+#define  T0PR					SIM_T0PR
+#define  T0MR0					SIM_T0MR0
+#define  T0MCR					SIM_T0MCR
+#define  T0IR					SIM_T0IR
+
+#define  MAMCR					SIM_MAMCR
+#define  MAMTIM				SIM_MAMTIM
+
+
+// firmware hooks. A task run by SCHED_Run() is work, the main loop is
+// not waiting for the busses yet, see CAN_SimNext().
+void  CAN_SimEvent ( void);
+
+#define  SCHED_RUN_HOOK()		CAN_SimEvent()
+
+
+#endif
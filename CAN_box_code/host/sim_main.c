@@ -0,0 +1,295 @@
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "datatypes.h"
+#include "can.h"
+#include "stats.h"
+#include "load.h"
+#include "can_user.h"
+#include "snap.h"
+#include "sim.h"
+
+
+//
+// router_sim [-r] [-t] [-n] [-b bus] [-p profile] [-c frames]
+//            [-s step_ns] [-q quiet_us] [-f bus,start_ms,len_ms] [log]
+//
+// Replays a candump log or a PCAN-View trace file, from stdin without a
+// file name, through the router and prints the frames it sends in
+// candump -L format. can0 is CAN1, can1 is CAN2. Accepts candump -L lines
+//		(1436509052.249713) can0 123#DEADBEEF
+// the default candump output
+//		can0  123   [4]  DE AD BE EF
+// and .trc files of version 1.0 to 2.1. Lines without a timestamp are
+// sent back to back.
+//
+// The end report on stderr has the counters of the simulated busses and
+// of the router, the frame rate and the host time per received frame.
+// With the virtual clock the counters are the same on every run, the
+// host times depend on the machine.
+//
+//	-r		run at real time on the host clock instead of as fast as
+//			possible on the virtual clock
+//	-t		ignore timestamps, send all frames back to back
+//	-n		don't print the sent frames
+//	-b		bus of trace files without a bus column, 1 or 2
+//	-p		instead of a log, generate a profile:
+//				load	both busses at 100 % load
+//				diag	30 % load, bursts of diagnostic requests on CAN1
+//	-c		frames per bus of the profile, default 100000
+//	-s		virtual clock per preemption point in ns
+//	-q		end of run after the end of the log and this idle time in us
+//	-f		bus fault on bus 1 or 2 from start_ms for len_ms, the bus goes
+//			off at each transmit and loses the received frames
+//
+
+
+int  router_main ( void);
+
+
+static FILE  *SIM_In;
+static u32_t  SIM_NoTime;
+static u32_t  SIM_Quiet;
+static s32_t  SIM_Profile = -1;
+static u32_t  SIM_Frames  = 100000;
+
+
+
+// SIM_Feeder()
+// feeder thread, reads the log
+static void*  SIM_Feeder ( void  *pArg)
+{
+	char  line[256];
+	SIM_Frame_t  f;
+	double  t, t0;
+
+
+	if ( SIM_Profile >= 0)
+	{
+		SIM_Gen ( SIM_Profile, SIM_Frames);
+		SIM_PutEnd();
+
+		return NULL;
+	}
+
+	t0 = -1;
+
+	while ( fgets ( line, sizeof ( line), SIM_In) != NULL)
+	{
+		if ( !SIM_TraceLine ( line, &f, &t))
+		{
+			continue;
+		}
+
+		if ( t >= 0  &&  !SIM_NoTime)
+		{
+			if ( t0 < 0)
+			{
+				t0 = t;
+			}
+
+			f.TimeNs = ( u64_t) ( ( t - t0) * 1e9);
+		}
+
+		SIM_Put ( &f);
+	}
+
+	SIM_PutEnd();
+
+	return NULL;
+}
+
+
+
+
+// SIM_PrintTx()
+// print a sent frame in candump -L format
+static void  SIM_PrintTx ( CANHandle_t  hBus, const CANMsg_t  *pMsg, u64_t  TimeNs)
+{
+	u32_t  i;
+
+
+	if ( SIM_Quiet)
+	{
+		return;
+	}
+
+	printf ( "(%llu.%06llu) can%u ", TimeNs / 1000000000ULL, ( TimeNs / 1000) % 1000000ULL, hBus);
+	printf ( pMsg->Type & CAN_MSG_EXTENDED ? "%08X#" : "%03X#", pMsg->Id);
+
+	if ( pMsg->Type & CAN_MSG_RTR)
+	{
+		printf ( "R");
+	}
+
+	else
+	{
+		for ( i = 0; i < pMsg->Len  &&  i < 8; i++)
+		{
+			printf ( "%02X", pMsg->Data8[i]);
+		}
+	}
+
+	printf ( "\n");
+}
+
+
+
+
+// SIM_Report()
+// print the counters and host times at the end of the run
+static void  SIM_Report ( void)
+{
+	u64_t  total, sim;
+	u32_t  b, rx, drop;
+
+
+	SIM_HostTime ( &total, &sim);
+
+	fflush ( stdout);
+
+	rx   = 0;
+	drop = 0;
+
+	for ( b = 0; b < SIM_BUSSES; b++)
+	{
+		SIM_Bus_t  *pS = &SIM_Bus[b];
+		volatile STAT_Bus_t  *pR = &STAT_Bus[b];
+
+
+		fprintf ( stderr, "CAN%u wire: rx %u filtered %u overrun %u queue full %u tx %u load %.1f %%\n",
+				b + 1, pS->RxFrames, pS->RxFiltered, pS->RxOverrun, pS->RxQueueFull, pS->TxFrames,
+				SIM_Now() ? 100.0 * pS->BusyNs / SIM_Now() : 0.0);
+
+		fprintf ( stderr, "CAN%u router: rx %u fwd %u filtered %u limited %u unchanged %u local %u rx lost %u tx retry %u tx drop %u expired %u rx hwm %u tx hwm %u\n",
+				b + 1, pR->Rx, pR->Forwarded, pR->Filtered, pR->Limited, pR->Unchanged, pR->Local, pR->RxLost, pR->TxRetry, pR->TxDrop, pR->Expired,
+				pR->RxHwm, pR->TxHwm);
+
+		fprintf ( stderr, "CAN%u load meter: 10 ms %.1f %% 100 ms %.1f %% 1 s %.1f %% peak %.1f %%\n",
+				b + 1, LOAD_Get ( b, LOAD_WIN_10MS) / 10.0, LOAD_Get ( b, LOAD_WIN_100MS) / 10.0,
+				LOAD_Get ( b, LOAD_WIN_1S) / 10.0, LOAD_Get ( b, LOAD_WIN_PEAK) / 10.0);
+
+		if ( pR->IsoTpSent  ||  pR->IsoTpAborted)
+		{
+			fprintf ( stderr, "CAN%u iso-tp: sent %u aborted %u\n", b + 1, pR->IsoTpSent, pR->IsoTpAborted);
+		}
+
+		if ( pR->RtrAnswered)
+		{
+			fprintf ( stderr, "CAN%u rtr proxy: answered %u\n", b + 1, pR->RtrAnswered);
+		}
+
+		if ( pR->J1939Sent  ||  pR->J1939Aborted)
+		{
+			fprintf ( stderr, "CAN%u j1939 tp: sent %u aborted %u\n", b + 1, pR->J1939Sent, pR->J1939Aborted);
+		}
+
+		if ( b == SIM_Cfg.FaultBus)
+		{
+			fprintf ( stderr, "CAN%u fault: rx lost %u bus off %u purged %u off %u ms max %u ms\n",
+					b + 1, pS->RxFault, pS->BusOff, pR->Purged, pR->OffMs, pR->OffMaxMs);
+		}
+
+		rx   += pR->Rx;
+		drop += pS->RxOverrun + pS->RxQueueFull + pR->RxLost + pR->TxDrop + pR->Expired;
+	}
+
+	fprintf ( stderr, "snapshot: %u of %u slots, lost %u\n", SNAP_Used(), SNAP_SLOTS, SNAP_Lost);
+
+	fprintf ( stderr, "time %.6f s, host %.6f s, %u frames, %u dropped\n",
+			SIM_Now() / 1e9, total / 1e9, rx, drop);
+
+	if ( rx > 0  &&  total > 0)
+	{
+		fprintf ( stderr, "host %.0f frames/s, %.1f ns/frame, router %.1f ns/frame\n",
+				rx * 1e9 / total, ( double) total / rx, ( double) ( total - sim) / rx);
+	}
+}
+
+
+
+
+int  main ( int  argc, char  **argv)
+{
+	pthread_t  feeder;
+	int  opt;
+
+
+	while ( ( opt = getopt ( argc, argv, "rtnb:p:c:s:q:f:")) != -1)
+	{
+		switch ( opt)
+		{
+			case 'r':	SIM_Cfg.Clock   = SIM_CLOCK_REAL;			break;
+			case 't':	SIM_NoTime      = 1;							break;
+			case 'n':	SIM_Quiet       = 1;							break;
+			case 'b':	SIM_TraceBus    = strtoul ( optarg, NULL, 0) - 1;	break;
+			case 'c':	SIM_Frames      = strtoul ( optarg, NULL, 0);	break;
+			case 's':	SIM_Cfg.StepNs  = strtoul ( optarg, NULL, 0);	break;
+			case 'q':	SIM_Cfg.QuietUs = strtoul ( optarg, NULL, 0);	break;
+
+			case 'f':
+			{
+				unsigned  bus, start, len;
+
+
+				if ( sscanf ( optarg, "%u,%u,%u", &bus, &start, &len) != 3  ||  bus < 1  ||  bus > SIM_BUSSES)
+				{
+					fprintf ( stderr, "%s: bad fault\n", optarg);
+					return 2;
+				}
+
+				SIM_Cfg.FaultBus     = bus - 1;
+				SIM_Cfg.FaultStartNs = ( u64_t) start * 1000000;
+				SIM_Cfg.FaultEndNs   = ( u64_t) ( start + len) * 1000000;
+				break;
+			}
+
+			case 'p':
+				if ( strcmp ( optarg, "load") == 0)
+				{
+					SIM_Profile = SIM_GEN_LOAD;
+					break;
+				}
+
+				if ( strcmp ( optarg, "diag") == 0)
+				{
+					SIM_Profile = SIM_GEN_DIAG;
+					break;
+				}
+
+				fprintf ( stderr, "%s: unknown profile\n", optarg);
+				return 2;
+
+			default:
+				fprintf ( stderr, "usage: %s [-r] [-t] [-n] [-b bus] [-p profile] [-c frames] [-s step_ns] [-q quiet_us] [-f bus,start_ms,len_ms] [log]\n", argv[0]);
+				return 2;
+		}
+	}
+
+	SIM_In = stdin;
+
+	if ( optind < argc  &&  SIM_Profile < 0)
+	{
+		SIM_In = fopen ( argv[optind], "r");
+
+		if ( SIM_In == NULL)
+		{
+			perror ( argv[optind]);
+			return 1;
+		}
+	}
+
+	SIM_Cfg.TxHook  = SIM_PrintTx;
+	SIM_Cfg.EndHook = SIM_Report;
+
+	SIM_Start();
+
+	pthread_create ( &feeder, NULL, SIM_Feeder, NULL);
+
+	// returns through SIM_Cfg.EndHook and exit()
+	return router_main();
+}
@@ -0,0 +1,461 @@
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "datatypes.h"
+#include "can.h"
+#include "sim.h"
+
+
+//
+// Trace input for the simulation and host/bench_decode: candump logs and
+// PCAN-View trace files.
+//
+
+
+// PCAN-View trace columns, see SIM_TraceColumns()
+#define  SIM_TRC_MAXCOL		16
+
+static struct {
+
+	u32_t			Version;						// file version * 10, 0 before a header
+	char			Columns[SIM_TRC_MAXCOL];	// column letters of a version 2 file
+	u32_t			nColumns;
+} SIM_Trc;
+
+// bus of traces without a bus column
+u32_t  SIM_TraceBus;
+
+
+
+
+// SIM_Hex()
+// parse up to Max hex digits, returns the number of digits
+static u32_t  SIM_Hex ( const char  **ppS, u32_t  Max, u32_t  *pValue)
+{
+	const char  *p = *ppS;
+	u32_t  n, v;
+
+
+	for ( n = 0, v = 0; n < Max  &&  isxdigit ( ( unsigned char) *p); n++, p++)
+	{
+		v = v << 4 | ( isdigit ( ( unsigned char) *p) ? *p - '0' : ( tolower ( ( unsigned char) *p) - 'a' + 10));
+	}
+
+	*ppS    = p;
+	*pValue = v;
+
+	return n;
+}
+
+
+
+
+// SIM_TraceCandump()
+// parse a candump line. Returns 1 for a frame.
+static u32_t  SIM_TraceCandump ( const char  *pLine, SIM_Frame_t  *pF, double  *pTime)
+{
+	const char  *p = pLine;
+	u32_t  n, v, i;
+
+
+	memset ( pF, 0, sizeof ( *pF));
+	*pTime = -1;
+
+	while ( isspace ( ( unsigned char) *p))
+	{
+		p++;
+	}
+
+	if ( *p == '(')
+	{
+		*pTime = strtod ( p + 1, NULL);
+		p = strchr ( p, ')');
+
+		if ( p == NULL)
+		{
+			return 0;
+		}
+
+		p++;
+
+		while ( isspace ( ( unsigned char) *p))
+		{
+			p++;
+		}
+	}
+
+	// interface, the trailing digit selects the bus
+	while ( isalpha ( ( unsigned char) *p))
+	{
+		p++;
+	}
+
+	if ( !isdigit ( ( unsigned char) *p))
+	{
+		return 0;
+	}
+
+	pF->Bus = strtoul ( p, ( char **) &p, 10);
+
+	while ( isspace ( ( unsigned char) *p))
+	{
+		p++;
+	}
+
+	n = SIM_Hex ( &p, 8, &v);
+
+	if ( n == 0)
+	{
+		return 0;
+	}
+
+	pF->Msg.Id   = v;
+	pF->Msg.Type = n > 3 ? CAN_MSG_EXTENDED : CAN_MSG_STANDARD;
+
+	if ( *p == '#')
+	{
+		// candump -L
+		p++;
+
+		if ( *p == 'R')
+		{
+			pF->Msg.Type |= CAN_MSG_RTR;
+			pF->Msg.Len   = isdigit ( ( unsigned char) p[1]) ? p[1] - '0' : 0;
+			return 1;
+		}
+
+		for ( i = 0; i < 8  &&  SIM_Hex ( &p, 2, &v) == 2; i++)
+		{
+			pF->Msg.Data8[i] = v;
+
+			if ( *p == '.')
+			{
+				p++;
+			}
+		}
+
+		pF->Msg.Len = i;
+		return 1;
+	}
+
+	// candump default output
+	p = strchr ( p, '[');
+
+	if ( p == NULL)
+	{
+		return 0;
+	}
+
+	pF->Msg.Len = strtoul ( p + 1, ( char **) &p, 10);
+
+	if ( pF->Msg.Len > 8  ||  *p != ']')
+	{
+		return 0;
+	}
+
+	p++;
+
+	if ( strstr ( p, "remote") != NULL)
+	{
+		pF->Msg.Type |= CAN_MSG_RTR;
+		return 1;
+	}
+
+	for ( i = 0; i < pF->Msg.Len; i++)
+	{
+		while ( isspace ( ( unsigned char) *p))
+		{
+			p++;
+		}
+
+		if ( SIM_Hex ( &p, 2, &v) != 2)
+		{
+			return 0;
+		}
+
+		pF->Msg.Data8[i] = v;
+	}
+
+	return 1;
+}
+
+
+
+
+// SIM_TraceColumns()
+// set the column letters of a version 2 trace from a $COLUMNS line
+static void  SIM_TraceColumns ( const char  *p)
+{
+	SIM_Trc.nColumns = 0;
+
+	for ( ; *p != '\0'  &&  SIM_Trc.nColumns < SIM_TRC_MAXCOL; p++)
+	{
+		if ( isalpha ( ( unsigned char) *p))
+		{
+			SIM_Trc.Columns[SIM_Trc.nColumns++] = *p;
+		}
+	}
+}
+
+
+
+
+// SIM_TraceHeader()
+// parse a PCAN-View header line
+static void  SIM_TraceHeader ( const char  *p)
+{
+	if ( strncmp ( p, ";$FILEVERSION=", 14) == 0)
+	{
+		SIM_Trc.Version = ( u32_t) ( strtod ( p + 14, NULL) * 10 + 0.5);
+
+		if ( SIM_Trc.Version == 20)
+		{
+			SIM_TraceColumns ( "N,O,T,I,d,l,D");
+		}
+	}
+
+	else if ( strncmp ( p, ";$COLUMNS=", 10) == 0)
+	{
+		SIM_TraceColumns ( p + 10);
+	}
+}
+
+
+
+
+// SIM_TraceData()
+// parse Len data bytes
+static u32_t  SIM_TraceData ( char  **pTok, u32_t  nTok, CANMsg_t  *pMsg)
+{
+	const char  *p;
+	u32_t  i, v;
+
+
+	if ( pMsg->Len > 8  ||  nTok < pMsg->Len)
+	{
+		return 0;
+	}
+
+	for ( i = 0; i < pMsg->Len; i++)
+	{
+		p = pTok[i];
+
+		if ( SIM_Hex ( &p, 2, &v) != 2)
+		{
+			return 0;
+		}
+
+		pMsg->Data8[i] = v;
+	}
+
+	return 1;
+}
+
+
+
+
+// SIM_TraceId()
+// parse an Id column, more than 4 digits make an extended frame
+static u32_t  SIM_TraceId ( const char  *p, CANMsg_t  *pMsg)
+{
+	u32_t  n, v;
+
+
+	n = SIM_Hex ( &p, 8, &v);
+
+	if ( n == 0  ||  *p != '\0')
+	{
+		return 0;
+	}
+
+	pMsg->Id   = v;
+	pMsg->Type = n > 4 ? CAN_MSG_EXTENDED : CAN_MSG_STANDARD;
+
+	return 1;
+}
+
+
+
+
+// SIM_TraceTrc1()
+// parse a version 1.x frame line
+//		1)      1059.9  1  Rx         0300  8  00 00 00 00 04 00 00 00
+// the bus column came with 1.2, the direction with 1.1, the '-' with 1.3
+static u32_t  SIM_TraceTrc1 ( char  **pTok, u32_t  nTok, SIM_Frame_t  *pF, double  *pTime)
+{
+	u32_t  i;
+
+
+	if ( nTok < 4  ||  pTok[0][strlen ( pTok[0]) - 1] != ')')
+	{
+		return 0;
+	}
+
+	*pTime = strtod ( pTok[1], NULL) / 1000;
+	i      = 2;
+
+	if ( SIM_Trc.Version >= 12)
+	{
+		pF->Bus = strtoul ( pTok[i++], NULL, 10) - 1;
+	}
+
+	if ( SIM_Trc.Version >= 11)
+	{
+		if ( strcmp ( pTok[i], "Rx") != 0  &&  strcmp ( pTok[i], "Tx") != 0)
+		{
+			// Warng, Error or Buff entries
+			return 0;
+		}
+
+		i++;
+	}
+
+	if ( i < nTok  &&  strcmp ( pTok[i], "-") == 0)
+	{
+		i++;
+	}
+
+	if ( i + 2 > nTok  ||  !SIM_TraceId ( pTok[i], &pF->Msg))
+	{
+		return 0;
+	}
+
+	pF->Msg.Len = strtoul ( pTok[i + 1], NULL, 10);
+	i += 2;
+
+	if ( i < nTok  &&  strcmp ( pTok[i], "RTR") == 0)
+	{
+		pF->Msg.Type |= CAN_MSG_RTR;
+		return pF->Msg.Len <= 8;
+	}
+
+	return SIM_TraceData ( pTok + i, nTok - i, &pF->Msg);
+}
+
+
+
+
+// SIM_TraceTrc2()
+// parse a version 2.x frame line by its columns
+//		1      1059.900 DT 1      0300 Rx -  8    00 00 00 00 04 00 00 00
+static u32_t  SIM_TraceTrc2 ( char  **pTok, u32_t  nTok, SIM_Frame_t  *pF, double  *pTime)
+{
+	u32_t  c, rtr;
+
+
+	rtr = 0;
+
+
+	for ( c = 0; c < SIM_Trc.nColumns  &&  c < nTok; c++)
+	{
+		const char  *p = pTok[c];
+
+
+		switch ( SIM_Trc.Columns[c])
+		{
+			case 'O':
+				*pTime = strtod ( p, NULL) / 1000;
+				break;
+
+			case 'T':
+				// CAN FD, status and error entries are skipped
+				if ( strcmp ( p, "RR") == 0)
+				{
+					rtr = 1;
+				}
+
+				else if ( strcmp ( p, "DT") != 0)
+				{
+					return 0;
+				}
+
+				break;
+
+			case 'B':
+				pF->Bus = strtoul ( p, NULL, 10) - 1;
+				break;
+
+			case 'I':
+				if ( !SIM_TraceId ( p, &pF->Msg))
+				{
+					return 0;
+				}
+
+				break;
+
+			case 'l':
+			case 'L':
+				pF->Msg.Len = strtoul ( p, NULL, 10);
+				break;
+
+			case 'D':
+				if ( rtr)
+				{
+					pF->Msg.Type |= CAN_MSG_RTR;
+					return pF->Msg.Len <= 8;
+				}
+
+				return SIM_TraceData ( pTok + c, nTok - c, &pF->Msg);
+
+			default:
+				break;
+		}
+	}
+
+	// a frame without data bytes ends before the D column
+	pF->Msg.Type |= rtr ? CAN_MSG_RTR : 0;
+
+	return c < SIM_Trc.nColumns  &&  SIM_Trc.Columns[c] == 'D'  &&  ( rtr  ||  pF->Msg.Len == 0);
+}
+
+
+
+
+// SIM_TraceLine()
+// parse a line of a candump log or a PCAN-View trace file. Returns 1
+// for a frame, *pTime is its time in s or negative without a time.
+u32_t  SIM_TraceLine ( const char  *pLine, SIM_Frame_t  *pF, double  *pTime)
+{
+	char  buf[256], *tok[SIM_TRC_MAXCOL + 8];
+	const char  *p = pLine;
+	u32_t  n;
+
+
+	while ( isspace ( ( unsigned char) *p))
+	{
+		p++;
+	}
+
+	if ( *p == ';')
+	{
+		SIM_TraceHeader ( p);
+		return 0;
+	}
+
+	// version 1.0 trace files have no header
+	if ( SIM_Trc.Version == 0  &&  ( *p == '('  ||  isalpha ( ( unsigned char) *p)))
+	{
+		return SIM_TraceCandump ( pLine, pF, pTime);
+	}
+
+	memset ( pF, 0, sizeof ( *pF));
+	*pTime  = -1;
+	pF->Bus = SIM_TraceBus;
+
+	snprintf ( buf, sizeof ( buf), "%s", p);
+
+	for ( n = 0, p = strtok ( buf, " \t\r\n"); p != NULL  &&  n < SIM_TRC_MAXCOL + 8; p = strtok ( NULL, " \t\r\n"))
+	{
+		tok[n++] = ( char *) p;
+	}
+
+	if ( n == 0)
+	{
+		return 0;
+	}
+
+	return SIM_Trc.Version < 20 ? SIM_TraceTrc1 ( tok, n, pF, pTime) : SIM_TraceTrc2 ( tok, n, pF, pTime);
+}
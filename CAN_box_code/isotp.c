@@ -0,0 +1,697 @@
+
+#include "datatypes.h"
+#include "lpc21xx.h"
+#include "can.h"
+#include "can_user.h"
+#include "isotp.h"
+#include "stats.h"
+#include "sched.h"
+#include "timer.h"
+
+
+#if ISOTP_BLOCKS > 255
+#error "ISOTP_BLOCKS is limited to 255, block indexes are u8_t"
+#endif
+
+#if ISOTP_SHARE_BLOCKS > ISOTP_BLOCKS
+#error "ISOTP_SHARE_BLOCKS is more than the pool"
+#endif
+
+
+// protocol control information, high nibble of the first byte
+#define  ISOTP_PCI_SF			0				// single frame
+#define  ISOTP_PCI_FF			1				// first frame
+#define  ISOTP_PCI_CF			2				// consecutive frame
+#define  ISOTP_PCI_FC			3				// flow control
+
+// flow status of a flow control
+#define  ISOTP_FS_CTS			0				// continue to send
+#define  ISOTP_FS_WAIT			1
+#define  ISOTP_FS_OVFLW		2				// overflow, the sender aborts
+
+// sending side of a link
+#define  ISOTP_TX_FF			0				// first frame to send
+#define  ISOTP_TX_WAIT			1				// waiting for a flow control
+#define  ISOTP_TX_CF			2				// sending consecutive frames
+
+#define  ISOTP_BLOCK_MASK		( ISOTP_BLOCK_SIZE - 1)
+
+
+// block pool, the free blocks are chained by ISOTP_Next[]
+static u8_t  ISOTP_Pool[ISOTP_BLOCKS][ISOTP_BLOCK_SIZE];
+static u8_t  ISOTP_Next[ISOTP_BLOCKS];
+static u8_t  ISOTP_FreeHead;
+static u8_t  ISOTP_FreeCount;
+
+volatile u8_t  ISOTP_Active;
+
+
+
+// ISOTP_Alloc()
+// returns a chain of Count blocks or ISOTP_BLOCK_NONE, also for more
+// than ISOTP_SHARE_BLOCKS while another message holds blocks
+u32_t  ISOTP_Alloc ( u32_t  Count)
+{
+	u32_t  head, last;
+	
+	
+	if ( Count > ISOTP_FreeCount  ||  ( Count > ISOTP_SHARE_BLOCKS  &&  ISOTP_FreeCount < ISOTP_BLOCKS))
+	{
+		return ISOTP_BLOCK_NONE;
+	}
+	
+	head = ISOTP_FreeHead;
+	last = head;
+	
+	ISOTP_FreeCount -= Count;
+	
+	while ( --Count > 0)
+	{
+		last = ISOTP_Next[last];
+	}
+	
+	ISOTP_FreeHead   = ISOTP_Next[last];
+	ISOTP_Next[last] = ISOTP_BLOCK_NONE;
+	
+	return head;
+}
+
+
+
+
+// ISOTP_Release()
+// return the chain at Head to the pool
+void  ISOTP_Release ( u32_t  Head)
+{
+	u32_t  last, n;
+	
+	
+	last = Head;
+	n    = 1;
+	
+	while ( ISOTP_Next[last] != ISOTP_BLOCK_NONE)
+	{
+		last = ISOTP_Next[last];
+		n++;
+	}
+	
+	ISOTP_Next[last] = ISOTP_FreeHead;
+	ISOTP_FreeHead   = Head;
+	ISOTP_FreeCount += n;
+}
+
+
+
+
+// ISOTP_Write()
+// copy n bytes to position Pos of the chain at Head. The block of Pos is
+// found from the head, for random access by j1939.c.
+void  ISOTP_Write ( u32_t  Head, u32_t  Pos, const u8_t  *pSrc, u32_t  n)
+{
+	u32_t  b;
+	
+	
+	for ( b = Pos / ISOTP_BLOCK_SIZE; b > 0; b--)
+	{
+		Head = ISOTP_Next[Head];
+	}
+	
+	while ( n-- > 0)
+	{
+		ISOTP_Pool[Head][Pos & ISOTP_BLOCK_MASK] = *pSrc++;
+		
+		if ( ( ++Pos & ISOTP_BLOCK_MASK) == 0  &&  n > 0)
+		{
+			Head = ISOTP_Next[Head];
+		}
+	}
+}
+
+
+
+
+// ISOTP_Read()
+// copy n bytes from position Pos of the chain at Head
+void  ISOTP_Read ( u32_t  Head, u32_t  Pos, u8_t  *pDst, u32_t  n)
+{
+	u32_t  b;
+	
+	
+	for ( b = Pos / ISOTP_BLOCK_SIZE; b > 0; b--)
+	{
+		Head = ISOTP_Next[Head];
+	}
+	
+	while ( n-- > 0)
+	{
+		*pDst++ = ISOTP_Pool[Head][Pos & ISOTP_BLOCK_MASK];
+		
+		if ( ( ++Pos & ISOTP_BLOCK_MASK) == 0  &&  n > 0)
+		{
+			Head = ISOTP_Next[Head];
+		}
+	}
+}
+
+
+
+
+// ISOTP_Frame()
+// returns a Tx slot on hBus filled in with Id, type and padding of the
+// channel, NULL when the Tx queue is full. The caller sets the data and
+// commits.
+static CANMsg_t*  ISOTP_Frame ( CANHandle_t  hBus, const ISOTP_Chan_t  *pCh, u32_t  Id)
+{
+	CANMsg_t  *pTx;
+	
+	
+	pTx = CAN_UserTxAlloc ( hBus);
+	
+	if ( pTx != NULL)
+	{
+		pTx->Id   = Id;
+		pTx->Type = pCh->Type;
+		pTx->Len  = 8;
+		
+		pTx->Data32[0] = pCh->Pad * 0x01010101U;
+		pTx->Data32[1] = pCh->Pad * 0x01010101U;
+	}
+	
+	return pTx;
+}
+
+
+
+
+// ISOTP_SendFc()
+// send a flow control on hSrc to the sender of channel Chan. Returns 0
+// when the Tx queue is full.
+static u32_t  ISOTP_SendFc ( CANHandle_t  hSrc, u32_t  Chan, u32_t  Status)
+{
+	const ISOTP_Chan_t  *pCh;
+	CANMsg_t  *pTx;
+	
+	
+	pCh = &ISOTP_Chans[Chan];
+	pTx = ISOTP_Frame ( hSrc, pCh, pCh->Id[hSrc ^ 1]);
+	
+	if ( pTx == NULL)
+	{
+		return 0;
+	}
+	
+	pTx->Data8[0] = ISOTP_PCI_FC << 4 | Status;
+	pTx->Data8[1] = 0;
+	pTx->Data8[2] = ISOTP_STMIN;
+	
+	CAN_UserTxCommit ( hSrc, CAN_USER_NO_DEADLINE);
+	
+	return 1;
+}
+
+
+
+
+// ISOTP_SendSf()
+// send the single frame which waited for the link, dropped on a full Tx
+// queue
+static void  ISOTP_SendSf ( ISOTP_Link_t  *pL, CANHandle_t  hDst, const ISOTP_Chan_t  *pCh)
+{
+	CANMsg_t  *pTx;
+	
+	
+	pTx = CAN_UserTxAlloc ( hDst);
+	
+	if ( pTx == NULL)
+	{
+		STAT_Bus[hDst].TxDrop++;
+	}
+	
+	else
+	{
+		pTx->Id        = pCh->Id[hDst ^ 1];
+		pTx->Type      = pCh->Type;
+		pTx->Len       = pL->SfLen;
+		pTx->Data32[0] = pL->SfData32[0];
+		pTx->Data32[1] = pL->SfData32[1];
+		
+		CAN_UserTxCommit ( hDst, CAN_USER_NO_DEADLINE);
+	}
+	
+	pL->SfLen = 0;
+}
+
+
+
+
+// ISOTP_Free()
+// end the message of a link, its blocks go back to the pool
+static void  ISOTP_Free ( u32_t  Chan, CANHandle_t  hSrc)
+{
+	ISOTP_Link_t  *pL;
+	
+	
+	pL = &ISOTP_Links[Chan][hSrc];
+	
+	ISOTP_Release ( pL->Head);
+	
+	pL->Len = 0;
+	pL->Fc  = 0;
+	ISOTP_Active--;
+	
+	if ( pL->SfLen)
+	{
+		ISOTP_SendSf ( pL, hSrc ^ 1, &ISOTP_Chans[Chan]);
+	}
+}
+
+
+
+
+// ISOTP_Abort()
+// drop the message of a link, counted for the bus it was sent to
+static void  ISOTP_Abort ( u32_t  Chan, CANHandle_t  hSrc)
+{
+	STAT_Bus[hSrc ^ 1].IsoTpAborted++;
+	ISOTP_Free ( Chan, hSrc);
+}
+
+
+
+
+// ISOTP_Put()
+// append received payload to a link
+static void  ISOTP_Put ( ISOTP_Link_t  *pL, const u8_t  *pSrc, u32_t  n)
+{
+	while ( n-- > 0)
+	{
+		if ( ( pL->RxPos & ISOTP_BLOCK_MASK) == 0  &&  pL->RxPos > 0)
+		{
+			pL->RxBlk = ISOTP_Next[pL->RxBlk];
+		}
+		
+		ISOTP_Pool[pL->RxBlk][pL->RxPos & ISOTP_BLOCK_MASK] = *pSrc++;
+		pL->RxPos++;
+	}
+}
+
+
+
+
+// ISOTP_Get()
+// take payload to send from a link
+static void  ISOTP_Get ( ISOTP_Link_t  *pL, u8_t  *pDst, u32_t  n)
+{
+	while ( n-- > 0)
+	{
+		if ( ( pL->TxPos & ISOTP_BLOCK_MASK) == 0  &&  pL->TxPos > 0)
+		{
+			pL->TxBlk = ISOTP_Next[pL->TxBlk];
+		}
+		
+		*pDst++ = ISOTP_Pool[pL->TxBlk][pL->TxPos & ISOTP_BLOCK_MASK];
+		pL->TxPos++;
+	}
+}
+
+
+
+
+// ISOTP_StMinUs()
+// separation time of a flow control in microseconds, reserved values
+// count as the longest
+static u32_t  ISOTP_StMinUs ( u32_t  StMin)
+{
+	if ( StMin <= 0x7F)
+	{
+		return StMin * 1000;
+	}
+	
+	if ( StMin >= 0xF1  &&  StMin <= 0xF9)
+	{
+		return ( StMin - 0xF0) * 100;
+	}
+	
+	return 0x7F * 1000;
+}
+
+
+
+
+// ISOTP_First()
+// start a message with its first frame
+static void  ISOTP_First ( CANHandle_t  hSrc, u32_t  Chan, CANRxMsg_t  *pMsg)
+{
+	ISOTP_Link_t  *pL;
+	u32_t  len, head;
+	
+	
+	pL  = &ISOTP_Links[Chan][hSrc];
+	len = ( pMsg->Data8[0] & 0x0F) << 8 | pMsg->Data8[1];
+	
+	// a single frame would have done
+	if ( pMsg->Len < 8  ||  len < 8)
+	{
+		return;
+	}
+	
+	if ( pL->Len)
+	{
+		// the previous message is still being sent
+		if ( pL->RxPos == pL->Len)
+		{
+			STAT_Bus[hSrc ^ 1].IsoTpAborted++;
+			ISOTP_SendFc ( hSrc, Chan, ISOTP_FS_OVFLW);
+			return;
+		}
+		
+		// the sender started over
+		ISOTP_Abort ( Chan, hSrc);
+	}
+	
+	head = ISOTP_Alloc ( ( len + ISOTP_BLOCK_SIZE - 1) / ISOTP_BLOCK_SIZE);
+	
+	if ( head == ISOTP_BLOCK_NONE)
+	{
+		STAT_Bus[hSrc ^ 1].IsoTpAborted++;
+		ISOTP_SendFc ( hSrc, Chan, ISOTP_FS_OVFLW);
+		return;
+	}
+	
+	pL->Len     = len;
+	pL->Head    = head;
+	pL->RxBlk   = head;
+	pL->TxBlk   = head;
+	pL->RxPos   = 0;
+	pL->TxPos   = 0;
+	pL->RxSn    = 1;
+	pL->TxSn    = 1;
+	pL->TxState = ISOTP_TX_FF;
+	pL->Tick    = SCHED_Tick;
+	
+	ISOTP_Put ( pL, &pMsg->Data8[2], 6);
+	ISOTP_Active++;
+	
+	// the pump sends it when the Tx queue is full now
+	pL->Fc = !ISOTP_SendFc ( hSrc, Chan, ISOTP_FS_CTS);
+}
+
+
+
+
+// ISOTP_Consecutive()
+// append a consecutive frame, a lost frame aborts the message
+static void  ISOTP_Consecutive ( CANHandle_t  hSrc, u32_t  Chan, CANRxMsg_t  *pMsg)
+{
+	ISOTP_Link_t  *pL;
+	u32_t  n;
+	
+	
+	pL = &ISOTP_Links[Chan][hSrc];
+	
+	if ( pL->Len == 0  ||  pL->RxPos == pL->Len)
+	{
+		return;
+	}
+	
+	n = pL->Len - pL->RxPos < 7 ? pL->Len - pL->RxPos : 7;
+	
+	if ( ( pMsg->Data8[0] & 0x0F) != pL->RxSn  ||  pMsg->Len < n + 1)
+	{
+		ISOTP_Abort ( Chan, hSrc);
+		return;
+	}
+	
+	ISOTP_Put ( pL, &pMsg->Data8[1], n);
+	
+	pL->RxSn = ( pL->RxSn + 1) & 0x0F;
+	pL->Tick = SCHED_Tick;
+}
+
+
+
+
+// ISOTP_FlowControl()
+// take a flow control received on hBus for the message sent there
+static void  ISOTP_FlowControl ( CANHandle_t  hBus, u32_t  Chan, CANRxMsg_t  *pMsg)
+{
+	ISOTP_Link_t  *pL;
+	
+	
+	pL = &ISOTP_Links[Chan][hBus ^ 1];
+	
+	if ( pL->Len == 0  ||  pL->TxState != ISOTP_TX_WAIT  ||  pMsg->Len < 3)
+	{
+		return;
+	}
+	
+	switch ( pMsg->Data8[0] & 0x0F)
+	{
+		case ISOTP_FS_CTS:
+			pL->Bs      = pMsg->Data8[1];
+			pL->BsLeft  = pMsg->Data8[1];
+			pL->StMin   = pMsg->Data8[2];
+			pL->TxDue   = TIMER_GetUs();
+			pL->TxState = ISOTP_TX_CF;
+			pL->Tick    = SCHED_Tick;
+			break;
+		
+		case ISOTP_FS_WAIT:
+			pL->Tick = SCHED_Tick;
+			break;
+		
+		default:
+			ISOTP_Abort ( Chan, hBus ^ 1);
+			break;
+	}
+}
+
+
+
+
+// ISOTP_Rx()
+// take a frame of channel Chan received on hSrc. Returns 0 for a single
+// frame, which is forwarded as usual. Called by ROUTE_Process(), also
+// on interrupt level.
+u32_t  ISOTP_Rx ( CANHandle_t  hSrc, u32_t  Chan, CANRxMsg_t  *pMsg)
+{
+	ISOTP_Link_t  *pL;
+	
+	
+	if ( pMsg->Len == 0)
+	{
+		return 0;
+	}
+	
+	switch ( pMsg->Data8[0] >> 4)
+	{
+		case ISOTP_PCI_FF:
+			ISOTP_First ( hSrc, Chan, pMsg);
+			return 1;
+		
+		case ISOTP_PCI_CF:
+			ISOTP_Consecutive ( hSrc, Chan, pMsg);
+			return 1;
+		
+		case ISOTP_PCI_FC:
+			ISOTP_FlowControl ( hSrc, Chan, pMsg);
+			return 1;
+		
+		default:
+			break;
+	}
+	
+	pL = &ISOTP_Links[Chan][hSrc];
+	
+	if ( pL->Len == 0)
+	{
+		return 0;
+	}
+	
+	// the sender gave up on the message it was sending
+	if ( pL->RxPos < pL->Len)
+	{
+		ISOTP_Abort ( Chan, hSrc);
+		return 0;
+	}
+	
+	// wait for the message before, a newer one replaces it
+	pL->SfLen       = pMsg->Len;
+	pL->SfData32[0] = pMsg->Data32[0];
+	pL->SfData32[1] = pMsg->Data32[1];
+	
+	return 1;
+}
+
+
+
+
+// ISOTP_Send()
+// send what is due on a link
+static void  ISOTP_Send ( u32_t  Chan, CANHandle_t  hSrc)
+{
+	const ISOTP_Chan_t  *pCh;
+	ISOTP_Link_t  *pL;
+	CANHandle_t  hDst;
+	CANMsg_t  *pTx;
+	u32_t  n;
+	
+	
+	pCh  = &ISOTP_Chans[Chan];
+	pL   = &ISOTP_Links[Chan][hSrc];
+	hDst = hSrc ^ 1;
+	
+	if ( pL->Fc  &&  ISOTP_SendFc ( hSrc, Chan, ISOTP_FS_CTS))
+	{
+		pL->Fc = 0;
+	}
+	
+	// only what the transmit buffers take at once, the spill area is
+	// left to the forwarded traffic. A frame which found no free buffer
+	// stays staged, nothing more is sent until it is out.
+	if ( CAN_UserTxStagedCount ( hDst) > 0)
+	{
+		return;
+	}
+	
+	if ( pL->TxState == ISOTP_TX_FF)
+	{
+		pTx = ISOTP_Frame ( hDst, pCh, pCh->Id[hSrc]);
+		
+		if ( pTx == NULL)
+		{
+			return;
+		}
+		
+		pTx->Data8[0] = ISOTP_PCI_FF << 4 | pL->Len >> 8;
+		pTx->Data8[1] = pL->Len;
+		
+		ISOTP_Get ( pL, &pTx->Data8[2], 6);
+		CAN_UserTxCommit ( hDst, CAN_USER_NO_DEADLINE);
+		
+		pL->TxState = ISOTP_TX_WAIT;
+		pL->Tick    = SCHED_Tick;
+		return;
+	}
+	
+	while ( pL->TxState == ISOTP_TX_CF)
+	{
+		n = pL->Len - pL->TxPos < 7 ? pL->Len - pL->TxPos : 7;
+		
+		// data not received yet, separation time not over or the frame
+		// before staged
+		if ( pL->RxPos - pL->TxPos < n  ||  ( s32_t) ( TIMER_GetUs() - pL->TxDue) < 0  ||
+				CAN_UserTxStagedCount ( hDst) > 0)
+		{
+			return;
+		}
+		
+		pTx = ISOTP_Frame ( hDst, pCh, pCh->Id[hSrc]);
+		
+		if ( pTx == NULL)
+		{
+			return;
+		}
+		
+		pTx->Data8[0] = ISOTP_PCI_CF << 4 | pL->TxSn;
+		
+		ISOTP_Get ( pL, &pTx->Data8[1], n);
+		CAN_UserTxCommit ( hDst, CAN_USER_NO_DEADLINE);
+		
+		pL->TxSn  = ( pL->TxSn + 1) & 0x0F;
+		pL->TxDue = TIMER_GetUs() + ISOTP_StMinUs ( pL->StMin);
+		pL->Tick  = SCHED_Tick;
+		
+		if ( pL->TxPos == pL->Len)
+		{
+			STAT_Bus[hDst].IsoTpSent++;
+			ISOTP_Free ( Chan, hSrc);
+			return;
+		}
+		
+		if ( pL->Bs  &&  --pL->BsLeft == 0)
+		{
+			pL->TxState = ISOTP_TX_WAIT;
+		}
+	}
+}
+
+
+
+
+// ISOTP_Pump()
+// send the frames which are due on all links, see ISOTP_Poll()
+void  ISOTP_Pump ( void)
+{
+	u32_t  c, lock;
+	
+	
+	lock = CAN_UserLock();
+	
+	for ( c = 1; c < ISOTP_ChanCount; c++)
+	{
+		if ( ISOTP_Links[c][CAN_BUS1].Len)
+		{
+			ISOTP_Send ( c, CAN_BUS1);
+		}
+		
+		if ( ISOTP_Links[c][CAN_BUS2].Len)
+		{
+			ISOTP_Send ( c, CAN_BUS2);
+		}
+	}
+	
+	CAN_UserUnlock ( lock);
+}
+
+
+
+
+// ISOTP_Task()
+// scheduled every 10 ms, aborts the messages without progress
+static void  ISOTP_Task ( void)
+{
+	CANHandle_t  hBus;
+	u32_t  c, lock;
+	
+	
+	lock = CAN_UserLock();
+	
+	for ( c = 1; c < ISOTP_ChanCount; c++)
+	{
+		for ( hBus = CAN_BUS1; hBus <= CAN_BUS2; hBus++)
+		{
+			if ( ISOTP_Links[c][hBus].Len  &&  SCHED_Tick - ISOTP_Links[c][hBus].Tick >= ISOTP_TIMEOUT_MS)
+			{
+				ISOTP_Abort ( c, hBus);
+			}
+		}
+	}
+	
+	CAN_UserUnlock ( lock);
+}
+
+
+
+
+// ISOTP_Init()
+// chain the pool into the free list and register the timeout task. Runs
+// before J1939_Init(), which takes blocks from the pool.
+void  ISOTP_Init ( void)
+{
+	u32_t  i;
+	
+	
+	for ( i = 0; i < ISOTP_BLOCKS; i++)
+	{
+		ISOTP_Next[i] = i + 1 < ISOTP_BLOCKS ? i + 1 : ISOTP_BLOCK_NONE;
+	}
+	
+	ISOTP_FreeHead  = 0;
+	ISOTP_FreeCount = ISOTP_BLOCKS;
+	
+	if ( ISOTP_ChanCount > 1)
+	{
+		SCHED_Add ( ISOTP_Task, 10, 10, 10);
+	}
+}
@@ -0,0 +1,141 @@
+
+#ifndef  _ISOTP_H_
+#define  _ISOTP_H_
+
+
+// ISO-TP (ISO 15765-2) gateway. A channel is a pair of Ids, one received
+// on each bus, which are routed with ROUTE_ACT_ISOTP. Single frames are
+// forwarded like any other message. Segmented messages are terminated on
+// both sides: the router answers the first frame with its own flow
+// control, buffers the payload and sends it on the other bus at the pace
+// of the flow control received there. Sending starts with the first
+// frame, consecutive frames follow as soon as their data has arrived.
+// The payload lives in a pool of fixed blocks, a message takes the blocks
+// for its length at the first frame or is refused with an overflow.
+// A direction holds one message. A single frame received while the one
+// before is still being sent waits for it, a first frame is refused.
+
+
+// block pool, shared by all channels and the J1939 sessions.
+// ISOTP_BLOCK_SIZE is a power of two. The pool must hold ISOTP_MAX_LEN,
+// a smaller one refuses the longest messages, FASTRUN=1 included.
+#ifndef  ISOTP_BLOCK_SIZE
+#define  ISOTP_BLOCK_SIZE		64
+#endif
+
+#ifndef  ISOTP_BLOCKS
+#define  ISOTP_BLOCKS			64
+#endif
+
+// blocks a message may take while another one holds blocks of the pool.
+// A message which finds the pool unused may take all of it, the default
+// pool holds a 4095 byte message, and the others are refused while it
+// lasts. Beside a running message one of up to 2 KB is taken, so two of
+// that size run at once, or one and several short ones. The 1785 bytes
+// of J1939 are within the share.
+#ifndef  ISOTP_SHARE_BLOCKS
+#define  ISOTP_SHARE_BLOCKS		( ISOTP_BLOCKS / 2)
+#endif
+
+// separation time asked from the senders. The whole message is
+// buffered, so the flow control has no block size.
+#ifndef  ISOTP_STMIN
+#define  ISOTP_STMIN				0
+#endif
+
+// N_Bs and N_Cr, a session without progress for this long is aborted
+#ifndef  ISOTP_TIMEOUT_MS
+#define  ISOTP_TIMEOUT_MS		1000
+#endif
+
+#define  ISOTP_MAX_LEN			4095			// 12 bit length of classic CAN
+#define  ISOTP_BLOCK_NONE		0xFF
+
+
+// A channel. Messages received with Id[hBus] are sent with the same Id
+// on the other bus, the flow control for them is sent with the Id of the
+// other bus. Frames the router builds are padded to 8 bytes with Pad.
+typedef struct {
+
+	u32_t			Id[2];						// Id received on CAN1 and CAN2
+	u8_t			Type;							// CAN_MSG_STANDARD or CAN_MSG_EXTENDED
+	u8_t			Pad;							// padding byte
+	u8_t			N_A[2];						// not used
+} ISOTP_Chan_t;
+
+
+// State of one direction of a channel, a message received on one bus
+// and sent on the other
+typedef struct {
+
+	u16_t			Len;							// message length, 0 while idle
+	u16_t			RxPos;						// bytes received
+	u16_t			TxPos;						// bytes sent
+	u8_t			Head;							// first block
+	u8_t			RxBlk;						// block of RxPos
+	u8_t			TxBlk;						// block of TxPos
+	u8_t			RxSn;							// next sequence number expected
+	u8_t			TxSn;							// next sequence number sent
+	u8_t			TxState;						// see isotp.c
+	u8_t			Fc;							// flow control to send to the sender, 0 for none
+	u8_t			Bs;							// block size granted by the receiver, 0 for all
+	u8_t			BsLeft;						// consecutive frames left in the block
+	u8_t			StMin;						// separation time granted by the receiver
+	u8_t			SfLen;						// length of the waiting single frame, 0 for none
+	u8_t			N_A[3];						// not used
+	u32_t			TxDue;						// TIMER_GetUs() of the next consecutive frame
+	u32_t			Tick;							// SCHED_Tick of the last progress
+	u32_t			SfData32[2];				// data of the waiting single frame
+} ISOTP_Link_t;
+
+
+// Channels, defined in router_cfg.c. Link [n][hBus] carries the messages
+// of channel n received on hBus.
+extern const ISOTP_Chan_t  ISOTP_Chans[];
+extern ISOTP_Link_t  ISOTP_Links[][2];
+extern const u32_t  ISOTP_ChanCount;
+
+
+// links with a message, ISOTP_Poll() skips the walk without one
+extern volatile u8_t  ISOTP_Active;
+
+
+// isotp function protos
+
+u32_t  ISOTP_Rx ( CANHandle_t  hSrc, u32_t  Chan, CANRxMsg_t  *pMsg);
+
+
+void  ISOTP_Pump ( void);
+
+
+void  ISOTP_Init ( void);
+
+
+// block pool, also used by j1939.c. Callers hold CAN_UserLock() or run
+// on interrupt level.
+
+u32_t  ISOTP_Alloc ( u32_t  Count);
+
+
+void  ISOTP_Release ( u32_t  Head);
+
+
+void  ISOTP_Write ( u32_t  Head, u32_t  Pos, const u8_t  *pSrc, u32_t  n);
+
+
+void  ISOTP_Read ( u32_t  Head, u32_t  Pos, u8_t  *pDst, u32_t  n);
+
+
+
+// ISOTP_Poll()
+// called from the main loop, sends what is due
+static inline void  ISOTP_Poll ( void)
+{
+	if ( ISOTP_Active)
+	{
+		ISOTP_Pump();
+	}
+}
+
+
+#endif
@@ -0,0 +1,806 @@
+
+#include "datatypes.h"
+#include "lpc21xx.h"
+#include "can.h"
+#include "can_user.h"
+#include "router.h"
+#include "isotp.h"
+#include "j1939.h"
+#include "stats.h"
+#include "sched.h"
+#include "timer.h"
+
+
+// control byte of a TP.CM
+#define  J1939_CM_RTS			16				// request to send
+#define  J1939_CM_CTS			17				// clear to send
+#define  J1939_CM_EOMA			19				// end of message acknowledge
+#define  J1939_CM_BAM			32				// broadcast announce
+#define  J1939_CM_ABORT		255
+
+// abort reasons
+#define  J1939_ABORT_BUSY		1				// no session or pool space left
+#define  J1939_ABORT_TIMEOUT	3
+#define  J1939_ABORT_SEQUENCE	7				// bad sequence number
+
+// sending side of a session
+#define  J1939_TX_CM			0				// BAM or RTS to send
+#define  J1939_TX_WAIT			1				// waiting for a CTS
+#define  J1939_TX_DT			2				// sending data packets
+#define  J1939_TX_EOMA			3				// all sent, waiting for the EoMA
+
+// who is told about an abort, see J1939_Abort()
+#define  J1939_TO_SENDER		1
+#define  J1939_TO_RECEIVER		2
+
+// work for J1939_Task(), bits of J1939_Pending[]
+#define  J1939_PEND_REQUEST	1				// ask for the address claims
+#define  J1939_PEND_CLAIM		2				// send the claim of the router
+
+#define  J1939_MAX_LEN			1785			// 255 packets of 7 bytes
+
+// bytes 1 to 4 of RTS, BAM and EoMA
+#define  J1939_SIZE_ARG(pS)	( ( pS)->Len | ( pS)->Packets << 16 | 0xFFU << 24)
+
+
+static J1939_Session_t  J1939_Sessions[J1939_SESSIONS];
+
+// bus + 1 an address was last seen on, 0 while unknown. 2 bits per
+// address, 4 addresses per byte.
+static u8_t  J1939_AddrBus[256 / 4];
+
+#define  J1939_ADDR_SHIFT(Sa)	( ( ( Sa) & 3) * 2)
+#define  J1939_ADDR_BUS(Sa)		( J1939_AddrBus[( Sa) >> 2] >> J1939_ADDR_SHIFT ( Sa) & 3)
+
+// 1 while the router holds J1939_ADDRESS on a bus
+static u8_t  J1939_Claimed[2];
+
+static volatile u8_t  J1939_Pending[2];
+
+volatile u8_t  J1939_Active;
+
+
+
+// J1939_Frame()
+// returns a Tx slot on hBus with Id and 8 bytes of 0xFF, NULL when the
+// Tx queue is full. The caller sets the data and commits.
+static CANMsg_t*  J1939_Frame ( CANHandle_t  hBus, u32_t  Id)
+{
+	CANMsg_t  *pTx;
+	
+	
+	pTx = CAN_UserTxAlloc ( hBus);
+	
+	if ( pTx != NULL)
+	{
+		pTx->Id        = Id;
+		pTx->Type      = CAN_MSG_EXTENDED;
+		pTx->Len       = 8;
+		pTx->Data32[0] = 0xFFFFFFFF;
+		pTx->Data32[1] = 0xFFFFFFFF;
+	}
+	
+	return pTx;
+}
+
+
+
+
+// J1939_SendCm()
+// send a TP.CM with control byte Ctrl, bytes 1 to 4 from Arg and the PGN
+// of the message. Returns 0 when the Tx queue is full.
+static u32_t  J1939_SendCm ( CANHandle_t  hBus, u32_t  Id, u32_t  Ctrl, u32_t  Arg, u32_t  Pgn)
+{
+	CANMsg_t  *pTx;
+	
+	
+	pTx = J1939_Frame ( hBus, Id);
+	
+	if ( pTx == NULL)
+	{
+		return 0;
+	}
+	
+	pTx->Data8[0] = Ctrl;
+	pTx->Data8[1] = Arg;
+	pTx->Data8[2] = Arg >> 8;
+	pTx->Data8[3] = Arg >> 16;
+	pTx->Data8[4] = Arg >> 24;
+	pTx->Data8[5] = Pgn;
+	pTx->Data8[6] = Pgn >> 8;
+	pTx->Data8[7] = Pgn >> 16;
+	
+	CAN_UserTxCommit ( hBus, CAN_USER_NO_DEADLINE);
+	
+	return 1;
+}
+
+
+
+
+// J1939_ToSender()
+// send a TP.CM to the sender of a session, in the name of the receiver
+static u32_t  J1939_ToSender ( J1939_Session_t  *pS, u32_t  Ctrl, u32_t  Arg)
+{
+	return J1939_SendCm ( pS->Bus, J1939_Id ( pS->Prio, J1939_PGN_TP_CM, pS->Sa, pS->Da), Ctrl, Arg, pS->Pgn);
+}
+
+
+
+
+// J1939_ToReceiver()
+// send a TP.CM to the receiver of a session, in the name of the sender
+static u32_t  J1939_ToReceiver ( J1939_Session_t  *pS, u32_t  Ctrl, u32_t  Arg)
+{
+	return J1939_SendCm ( pS->Bus ^ 1, J1939_Id ( pS->Prio, J1939_PGN_TP_CM, pS->Da, pS->Sa), Ctrl, Arg, pS->Pgn);
+}
+
+
+
+
+// J1939_Reply()
+// send the pending CTS or EoMA to the sender, kept for the pump when
+// the Tx queue is full
+static void  J1939_Reply ( J1939_Session_t  *pS)
+{
+	u32_t  arg;
+	
+	
+	if ( pS->Reply == J1939_CM_CTS)
+	{
+		arg = ( pS->RxEnd - pS->RxCount) | ( pS->RxCount + 1) << 8 | 0xFFFFU << 16;
+	}
+	
+	else
+	{
+		arg = J1939_SIZE_ARG ( pS);
+	}
+	
+	if ( J1939_ToSender ( pS, pS->Reply, arg))
+	{
+		pS->Reply = 0;
+	}
+}
+
+
+
+
+// J1939_Find()
+// returns the session of a message from Sa to Da received on hBus, NULL
+// for none
+static J1939_Session_t*  J1939_Find ( CANHandle_t  hBus, u32_t  Sa, u32_t  Da)
+{
+	J1939_Session_t  *pS;
+	
+	
+	for ( pS = J1939_Sessions; pS < &J1939_Sessions[J1939_SESSIONS]; pS++)
+	{
+		if ( pS->Len  &&  pS->Bus == hBus  &&  pS->Sa == Sa  &&  pS->Da == Da)
+		{
+			return pS;
+		}
+	}
+	
+	return NULL;
+}
+
+
+
+
+// J1939_End()
+// end a session, its blocks go back to the pool
+static void  J1939_End ( J1939_Session_t  *pS)
+{
+	ISOTP_Release ( pS->Head);
+	
+	pS->Len = 0;
+	J1939_Active--;
+}
+
+
+
+
+// J1939_Abort()
+// drop the message of a session, counted for the bus it was sent to. To
+// tells which side of an RTS/CTS session learns about it, a side which
+// is done or hasn't started isn't told.
+static void  J1939_Abort ( J1939_Session_t  *pS, u32_t  Reason, u32_t  To)
+{
+	STAT_Bus[pS->Bus ^ 1].J1939Aborted++;
+	
+	if ( pS->Da != J1939_GLOBAL)
+	{
+		if ( ( To & J1939_TO_SENDER)  &&  pS->RxCount < pS->Packets)
+		{
+			J1939_ToSender ( pS, J1939_CM_ABORT, Reason | 0xFFFFFFU << 8);
+		}
+		
+		if ( ( To & J1939_TO_RECEIVER)  &&  pS->TxState != J1939_TX_CM)
+		{
+			J1939_ToReceiver ( pS, J1939_CM_ABORT, Reason | 0xFFFFFFU << 8);
+		}
+	}
+	
+	J1939_End ( pS);
+}
+
+
+
+
+// J1939_Refuse()
+// refuse a message without a session, an RTS is answered with an abort
+static void  J1939_Refuse ( CANHandle_t  hSrc, CANRxMsg_t  *pMsg, u32_t  Sa, u32_t  Da)
+{
+	STAT_Bus[hSrc ^ 1].J1939Aborted++;
+	
+	if ( Da != J1939_GLOBAL)
+	{
+		J1939_SendCm ( hSrc, J1939_Id ( J1939_PRIO ( pMsg->Id), J1939_PGN_TP_CM, Sa, Da), J1939_CM_ABORT,
+				J1939_ABORT_BUSY | 0xFFFFFFU << 8, pMsg->Data8[5] | pMsg->Data8[6] << 8 | pMsg->Data8[7] << 16);
+	}
+}
+
+
+
+
+// J1939_Start()
+// start a session with an RTS or a BAM received on hSrc
+static void  J1939_Start ( CANHandle_t  hSrc, CANRxMsg_t  *pMsg, u32_t  Sa, u32_t  Da)
+{
+	J1939_Session_t  *pS;
+	u32_t  len, packets, pgn, head;
+	
+	
+	len     = pMsg->Data8[1] | pMsg->Data8[2] << 8;
+	packets = pMsg->Data8[3];
+	pgn     = pMsg->Data8[5] | pMsg->Data8[6] << 8 | pMsg->Data8[7] << 16;
+	
+	if ( len < 9  ||  len > J1939_MAX_LEN  ||  packets != ( len + 6) / 7)
+	{
+		return;
+	}
+	
+	pS = J1939_Find ( hSrc, Sa, Da);
+	
+	if ( pS != NULL)
+	{
+		// the previous message is still being sent
+		if ( pS->RxCount == pS->Packets)
+		{
+			J1939_Refuse ( hSrc, pMsg, Sa, Da);
+			return;
+		}
+		
+		// the sender started over
+		J1939_Abort ( pS, 0, J1939_TO_RECEIVER);
+	}
+	
+	for ( pS = J1939_Sessions; pS < &J1939_Sessions[J1939_SESSIONS]  &&  pS->Len; pS++)
+	{
+	}
+	
+	head = ISOTP_BLOCK_NONE;
+	
+	if ( pS < &J1939_Sessions[J1939_SESSIONS])
+	{
+		head = ISOTP_Alloc ( ( len + ISOTP_BLOCK_SIZE - 1) / ISOTP_BLOCK_SIZE);
+	}
+	
+	if ( head == ISOTP_BLOCK_NONE)
+	{
+		J1939_Refuse ( hSrc, pMsg, Sa, Da);
+		return;
+	}
+	
+	pS->Len     = len;
+	pS->Packets = packets;
+	pS->Head    = head;
+	pS->Bus     = hSrc;
+	pS->Sa      = Sa;
+	pS->Da      = Da;
+	pS->Prio    = J1939_PRIO ( pMsg->Id);
+	pS->Pgn     = pgn;
+	pS->RxCount = 0;
+	pS->RxEnd   = packets;
+	pS->TxCount = 0;
+	pS->TxEnd   = 0;
+	pS->TxState = J1939_TX_CM;
+	pS->Reply   = 0;
+	pS->Tick    = SCHED_Tick;
+	
+	J1939_Active++;
+	
+	if ( Da != J1939_GLOBAL)
+	{
+		// 0xFF is no limit, a window of 0 would never end
+		pS->RxMax = pMsg->Data8[4] ? pMsg->Data8[4] : 0xFF;
+		
+		if ( pS->RxMax < packets)
+		{
+			pS->RxEnd = pS->RxMax;
+		}
+		
+		pS->Reply = J1939_CM_CTS;
+		J1939_Reply ( pS);
+	}
+}
+
+
+
+
+// J1939_Data()
+// take a TP.DT received on hSrc. Returns 0 when it belongs to no session.
+static u32_t  J1939_Data ( CANHandle_t  hSrc, CANRxMsg_t  *pMsg, u32_t  Sa, u32_t  Da)
+{
+	J1939_Session_t  *pS;
+	u32_t  pos, n;
+	
+	
+	pS = J1939_Find ( hSrc, Sa, Da);
+	
+	if ( pS == NULL)
+	{
+		return 0;
+	}
+	
+	// outside the packets granted
+	if ( pS->RxCount >= pS->RxEnd)
+	{
+		return 1;
+	}
+	
+	if ( pMsg->Data8[0] != pS->RxCount + 1)
+	{
+		J1939_Abort ( pS, J1939_ABORT_SEQUENCE, J1939_TO_SENDER | J1939_TO_RECEIVER);
+		return 1;
+	}
+	
+	pos = pS->RxCount * 7;
+	n   = pS->Len - pos < 7 ? pS->Len - pos : 7;
+	
+	ISOTP_Write ( pS->Head, pos, &pMsg->Data8[1], n);
+	
+	pS->RxCount++;
+	pS->Tick = SCHED_Tick;
+	
+	if ( pS->Da == J1939_GLOBAL)
+	{
+		return 1;
+	}
+	
+	if ( pS->RxCount == pS->Packets)
+	{
+		pS->Reply = J1939_CM_EOMA;
+		J1939_Reply ( pS);
+	}
+	
+	else if ( pS->RxCount == pS->RxEnd)
+	{
+		pS->RxEnd = pS->Packets - pS->RxCount > pS->RxMax ? pS->RxCount + pS->RxMax : pS->Packets;
+		pS->Reply = J1939_CM_CTS;
+		J1939_Reply ( pS);
+	}
+	
+	return 1;
+}
+
+
+
+
+// J1939_Control()
+// take a TP.CM received on hBus. Returns 0 when it isn't relayed by the
+// router and is forwarded as usual.
+static u32_t  J1939_Control ( CANHandle_t  hBus, CANRxMsg_t  *pMsg, u32_t  Sa, u32_t  Da)
+{
+	J1939_Session_t  *pS;
+	u32_t  next, n;
+	
+	
+	switch ( pMsg->Data8[0])
+	{
+		case J1939_CM_BAM:
+			if ( Da != J1939_GLOBAL)
+			{
+				return 0;
+			}
+			
+			J1939_Start ( hBus, pMsg, Sa, Da);
+			return 1;
+		
+		case J1939_CM_RTS:
+			// relayed when the receiver is on the other bus
+			if ( Da == J1939_GLOBAL  ||  J1939_ADDR_BUS ( Da) != ( hBus ^ 1) + 1)
+			{
+				return 0;
+			}
+			
+			J1939_Start ( hBus, pMsg, Sa, Da);
+			return 1;
+		
+		case J1939_CM_ABORT:
+			// from the sender
+			pS = J1939_Find ( hBus, Sa, Da);
+			
+			if ( pS != NULL)
+			{
+				J1939_Abort ( pS, pMsg->Data8[1], J1939_TO_RECEIVER);
+				return 1;
+			}
+			
+			break;
+		
+		default:
+			break;
+	}
+	
+	// the answers of a receiver on the other bus
+	pS = J1939_Find ( hBus ^ 1, Da, Sa);
+	
+	if ( pS == NULL)
+	{
+		return 0;
+	}
+	
+	switch ( pMsg->Data8[0])
+	{
+		case J1939_CM_CTS:
+			n    = pMsg->Data8[1];
+			next = pMsg->Data8[2];
+			
+			pS->Tick = SCHED_Tick;
+			
+			// 0 packets holds the connection open
+			if ( n == 0  ||  pS->TxState == J1939_TX_CM)
+			{
+				break;
+			}
+			
+			if ( next == 0  ||  next - 1 + n > pS->Packets)
+			{
+				J1939_Abort ( pS, J1939_ABORT_SEQUENCE, J1939_TO_SENDER | J1939_TO_RECEIVER);
+				break;
+			}
+			
+			// a retransmission starts before the packets sent
+			pS->TxCount = next - 1;
+			pS->TxEnd   = next - 1 + n;
+			pS->TxState = J1939_TX_DT;
+			break;
+		
+		case J1939_CM_EOMA:
+			if ( pS->TxState == J1939_TX_EOMA)
+			{
+				STAT_Bus[hBus].J1939Sent++;
+				J1939_End ( pS);
+			}
+			
+			break;
+		
+		case J1939_CM_ABORT:
+			J1939_Abort ( pS, pMsg->Data8[1], J1939_TO_SENDER);
+			break;
+		
+		default:
+			break;
+	}
+	
+	return 1;
+}
+
+
+
+
+// J1939_Claim()
+// an address claim received on hBus. A node with a lower NAME takes the
+// address of the router, a higher one is answered with the claim.
+static void  J1939_Claim ( CANHandle_t  hBus, CANRxMsg_t  *pMsg)
+{
+	u64_t  name;
+	
+	
+	if ( J1939_SA ( pMsg->Id) != J1939_ADDRESS  ||  !J1939_Claimed[hBus]  ||  pMsg->Len < 8)
+	{
+		return;
+	}
+	
+	name = pMsg->Data32[0] | ( u64_t) pMsg->Data32[1] << 32;
+	
+	if ( name < J1939_NAME)
+	{
+		J1939_Claimed[hBus] = 0;
+	}
+	
+	// the claim or cannot claim
+	J1939_Pending[hBus] |= J1939_PEND_CLAIM;
+}
+
+
+
+
+// J1939_Request()
+// a request received on hBus, the one for the address claim is answered.
+// Returns 1 when the request was for the router alone.
+static u32_t  J1939_Request ( CANHandle_t  hBus, CANRxMsg_t  *pMsg)
+{
+	u32_t  da;
+	
+	
+	da = J1939_Da ( pMsg->Id);
+	
+	if ( J1939_ADDRESS == J1939_NULL_ADDR  ||  ( da != J1939_GLOBAL  &&  da != J1939_ADDRESS)  ||  pMsg->Len < 3)
+	{
+		return 0;
+	}
+	
+	if ( ( pMsg->Data8[0] | pMsg->Data8[1] << 8 | pMsg->Data8[2] << 16) == J1939_PGN_ADDR_CLAIM)
+	{
+		J1939_Pending[hBus] |= J1939_PEND_CLAIM;
+	}
+	
+	return da == J1939_ADDRESS;
+}
+
+
+
+
+// J1939_Rx()
+// take a frame of a ROUTE_ACT_J1939 rule received on hSrc. Returns 0
+// when it is forwarded as usual. Called by ROUTE_Process(), also on
+// interrupt level.
+u32_t  J1939_Rx ( CANHandle_t  hSrc, CANRxMsg_t  *pMsg)
+{
+	u32_t  sa;
+	
+	
+	if ( !( pMsg->Type & CAN_MSG_EXTENDED))
+	{
+		return 0;
+	}
+	
+	sa = J1939_SA ( pMsg->Id);
+	
+	if ( sa < J1939_NULL_ADDR)
+	{
+		J1939_AddrBus[sa >> 2] = ( J1939_AddrBus[sa >> 2] & ~( 3 << J1939_ADDR_SHIFT ( sa))) |
+				( hSrc + 1) << J1939_ADDR_SHIFT ( sa);
+	}
+	
+	switch ( J1939_Pgn ( pMsg->Id))
+	{
+		case J1939_PGN_TP_CM:
+			return pMsg->Len == 8  &&  J1939_Control ( hSrc, pMsg, sa, J1939_Da ( pMsg->Id));
+		
+		case J1939_PGN_TP_DT:
+			return pMsg->Len == 8  &&  J1939_Data ( hSrc, pMsg, sa, J1939_Da ( pMsg->Id));
+		
+		case J1939_PGN_ADDR_CLAIM:
+			J1939_Claim ( hSrc, pMsg);
+			return 0;
+		
+		case J1939_PGN_REQUEST:
+			return J1939_Request ( hSrc, pMsg);
+		
+		default:
+			break;
+	}
+	
+	return 0;
+}
+
+
+
+
+// J1939_Send()
+// send what is due for a session on the other bus
+static void  J1939_Send ( J1939_Session_t  *pS)
+{
+	CANHandle_t  hDst;
+	CANMsg_t  *pTx;
+	u32_t  pos, n;
+	
+	
+	hDst = pS->Bus ^ 1;
+	
+	if ( pS->Reply)
+	{
+		J1939_Reply ( pS);
+	}
+	
+	// only what the transmit buffers take at once, the spill area is
+	// left to the forwarded traffic. A packet which found no free buffer
+	// stays staged, nothing more is sent until it is out.
+	if ( CAN_UserTxStagedCount ( hDst) > 0)
+	{
+		return;
+	}
+	
+	if ( pS->TxState == J1939_TX_CM)
+	{
+		if ( !J1939_ToReceiver ( pS, pS->Da == J1939_GLOBAL ? J1939_CM_BAM : J1939_CM_RTS, J1939_SIZE_ARG ( pS)))
+		{
+			return;
+		}
+		
+		pS->TxState = J1939_TX_WAIT;
+		pS->Tick    = SCHED_Tick;
+		
+		if ( pS->Da == J1939_GLOBAL)
+		{
+			pS->TxEnd   = pS->Packets;
+			pS->TxDue   = TIMER_GetUs() + J1939_BAM_GAP_MS * 1000;
+			pS->TxState = J1939_TX_DT;
+		}
+		
+		return;
+	}
+	
+	while ( pS->TxState == J1939_TX_DT)
+	{
+		// packet not received yet, BAM gap not over or the packet before
+		// staged
+		if ( pS->TxCount >= pS->RxCount  ||
+				( pS->Da == J1939_GLOBAL  &&  ( s32_t) ( TIMER_GetUs() - pS->TxDue) < 0)  ||
+				CAN_UserTxStagedCount ( hDst) > 0)
+		{
+			return;
+		}
+		
+		pTx = J1939_Frame ( hDst, J1939_Id ( pS->Prio, J1939_PGN_TP_DT, pS->Da, pS->Sa));
+		
+		if ( pTx == NULL)
+		{
+			return;
+		}
+		
+		pos = pS->TxCount * 7;
+		n   = pS->Len - pos < 7 ? pS->Len - pos : 7;
+		
+		pTx->Data8[0] = pS->TxCount + 1;
+		ISOTP_Read ( pS->Head, pos, &pTx->Data8[1], n);
+		
+		CAN_UserTxCommit ( hDst, CAN_USER_NO_DEADLINE);
+		
+		pS->TxCount++;
+		pS->TxDue = TIMER_GetUs() + J1939_BAM_GAP_MS * 1000;
+		pS->Tick  = SCHED_Tick;
+		
+		if ( pS->TxCount == pS->Packets)
+		{
+			if ( pS->Da == J1939_GLOBAL)
+			{
+				STAT_Bus[hDst].J1939Sent++;
+				J1939_End ( pS);
+				return;
+			}
+			
+			pS->TxState = J1939_TX_EOMA;
+		}
+		
+		else if ( pS->TxCount == pS->TxEnd)
+		{
+			pS->TxState = J1939_TX_WAIT;
+		}
+	}
+}
+
+
+
+
+// J1939_Pump()
+// send the frames which are due for all sessions, see J1939_Poll()
+void  J1939_Pump ( void)
+{
+	J1939_Session_t  *pS;
+	u32_t  lock;
+	
+	
+	lock = CAN_UserLock();
+	
+	for ( pS = J1939_Sessions; pS < &J1939_Sessions[J1939_SESSIONS]; pS++)
+	{
+		if ( pS->Len)
+		{
+			J1939_Send ( pS);
+		}
+	}
+	
+	CAN_UserUnlock ( lock);
+}
+
+
+
+
+// J1939_Task()
+// scheduled every 10 ms. Aborts the sessions without progress, sends the
+// address claim and the request for the claims.
+static void  J1939_Task ( void)
+{
+	J1939_Session_t  *pS;
+	CANHandle_t  hBus;
+	CANMsg_t  *pTx;
+	u32_t  sa, lock;
+	
+	
+	lock = CAN_UserLock();
+	
+	for ( pS = J1939_Sessions; pS < &J1939_Sessions[J1939_SESSIONS]; pS++)
+	{
+		if ( pS->Len  &&  SCHED_Tick - pS->Tick >= J1939_TIMEOUT_MS)
+		{
+			J1939_Abort ( pS, J1939_ABORT_TIMEOUT, J1939_TO_SENDER | J1939_TO_RECEIVER);
+		}
+	}
+	
+	for ( hBus = CAN_BUS1; hBus <= CAN_BUS2; hBus++)
+	{
+		sa = J1939_Claimed[hBus] ? J1939_ADDRESS : J1939_NULL_ADDR;
+		
+		if ( J1939_Pending[hBus] & J1939_PEND_CLAIM)
+		{
+			pTx = J1939_Frame ( hBus, J1939_Id ( J1939_PRIO_CLAIM, J1939_PGN_ADDR_CLAIM, J1939_GLOBAL, sa));
+			
+			if ( pTx != NULL)
+			{
+				pTx->Data32[0] = ( u32_t) J1939_NAME;
+				pTx->Data32[1] = ( u32_t) ( J1939_NAME >> 32);
+				
+				CAN_UserTxCommit ( hBus, CAN_USER_NO_DEADLINE);
+				J1939_Pending[hBus] &= ~J1939_PEND_CLAIM;
+			}
+		}
+		
+		if ( J1939_Pending[hBus] & J1939_PEND_REQUEST)
+		{
+			pTx = J1939_Frame ( hBus, J1939_Id ( J1939_PRIO_CLAIM, J1939_PGN_REQUEST, J1939_GLOBAL, sa));
+			
+			if ( pTx != NULL)
+			{
+				pTx->Len      = 3;
+				pTx->Data8[0] = J1939_PGN_ADDR_CLAIM & 0xFF;
+				pTx->Data8[1] = ( J1939_PGN_ADDR_CLAIM >> 8) & 0xFF;
+				pTx->Data8[2] = J1939_PGN_ADDR_CLAIM >> 16;
+				
+				CAN_UserTxCommit ( hBus, CAN_USER_NO_DEADLINE);
+				J1939_Pending[hBus] &= ~J1939_PEND_REQUEST;
+			}
+		}
+	}
+	
+	CAN_UserUnlock ( lock);
+}
+
+
+
+
+// J1939_Init()
+// register the task for the busses with a PGN table. Every node is asked
+// for its address claim, which tells the bus it is on. Runs after
+// ISOTP_Init(), the sessions take blocks from its pool.
+void  J1939_Init ( void)
+{
+	CANHandle_t  hBus;
+	u32_t  used;
+	
+	
+	used = 0;
+	
+	for ( hBus = CAN_BUS1; hBus <= CAN_BUS2; hBus++)
+	{
+		if ( ROUTE_Tables[hBus].PgnCount)
+		{
+			J1939_Pending[hBus] = J1939_PEND_REQUEST;
+			used = 1;
+			
+			if ( J1939_ADDRESS != J1939_NULL_ADDR)
+			{
+				J1939_Claimed[hBus]  = 1;
+				J1939_Pending[hBus] |= J1939_PEND_CLAIM;
+			}
+		}
+	}
+	
+	if ( used)
+	{
+		SCHED_Add ( J1939_Task, 10, 10, 10);
+	}
+}
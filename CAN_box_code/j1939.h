@@ -0,0 +1,175 @@
+
+#ifndef  _J1939_H_
+#define  _J1939_H_
+
+
+// SAE J1939 on 29 bit Ids. An Id holds priority, PGN and source address.
+// For PDU1 PGNs ( PF < 240) the PS byte is the destination address and
+// not part of the PGN, PDU2 PGNs are broadcast.
+//
+// A bus with a PGN table routes 29 bit Ids by PGN, see ROUTE_Table_t.
+// The transport protocol and network management PGNs go to a
+// ROUTE_ACT_J1939 rule. Multi-packet messages are then relayed by the
+// router: a BAM is received and sent again on the other bus at
+// J1939_BAM_GAP_MS, an RTS/CTS session is answered on the receiving bus
+// and opened anew on the other one. Both sides keep their own timing, a
+// slow bus doesn't hold up the sender. The payload lives in the block
+// pool of isotp.c, the 1785 bytes of a message are within the share of
+// ISOTP_SHARE_BLOCKS. Sending starts right away, packets follow as soon
+// as they have been received.
+//
+// An RTS/CTS session is only taken over when its destination address
+// was seen on the other bus, from its address claim or its transport
+// frames. J1939_Init() asks all nodes for their claim. Other sessions
+// are forwarded frame by frame.
+
+
+// sessions relayed at the same time. J1939 allows one BAM per source
+// address and one RTS/CTS session per address pair.
+#ifndef  J1939_SESSIONS
+#define  J1939_SESSIONS			4
+#endif
+
+// time between the packets of a BAM sent by the router, 50 to 200 ms
+#ifndef  J1939_BAM_GAP_MS
+#define  J1939_BAM_GAP_MS		50
+#endif
+
+// T2 and T3 of J1939-21, a session without progress for this long is
+// aborted
+#ifndef  J1939_TIMEOUT_MS
+#define  J1939_TIMEOUT_MS		1250
+#endif
+
+// address claimed by the router on every J1939 bus, J1939_NULL_ADDR for
+// none. The router has no arbitrary address capability, it goes without
+// an address when a node with a lower NAME claims it.
+#ifndef  J1939_ADDRESS
+#define  J1939_ADDRESS			J1939_NULL_ADDR
+#endif
+
+// NAME of the router, lower wins an address contention
+#ifndef  J1939_NAME
+#define  J1939_NAME				0x0000000000000001ULL
+#endif
+
+
+// addresses
+#define  J1939_NULL_ADDR		0xFE			// no address, cannot claim
+#define  J1939_GLOBAL			0xFF			// destination of broadcasts
+
+// PGNs
+#define  J1939_PGN_REQUEST		0x00EA00
+#define  J1939_PGN_TP_DT		0x00EB00			// transport data
+#define  J1939_PGN_TP_CM		0x00EC00			// transport connection management
+#define  J1939_PGN_ADDR_CLAIM	0x00EE00
+
+// priority of the address claim
+#define  J1939_PRIO_CLAIM		6
+
+
+// fields of an Id
+#define  J1939_PRIO(Id)			( ( ( Id) >> 26) & 7)
+#define  J1939_SA(Id)			( ( Id) & 0xFF)
+
+// PDU1 format, PF below 240
+#define  J1939_PDU1(Pgn)		( ( ( ( Pgn) >> 8) & 0xFF) < 240)
+
+
+// State of a relayed message, received on Bus and sent on the other bus.
+// Packets are counted from 0, the first one carries sequence number 1.
+typedef struct {
+
+	u16_t			Len;							// message size, 0 while idle
+	u8_t			Packets;						// packets of the message
+	u8_t			Head;							// first pool block
+	u8_t			Bus;							// bus the message is received on
+	u8_t			Sa;							// source address
+	u8_t			Da;							// destination address, J1939_GLOBAL for a BAM
+	u8_t			Prio;							// priority of the transport frames
+	u8_t			RxCount;						// packets received
+	u8_t			RxEnd;						// end of the packets granted to the sender
+	u8_t			RxMax;						// packets per CTS the sender takes
+	u8_t			TxCount;						// packets sent
+	u8_t			TxEnd;						// end of the packets granted by the receiver
+	u8_t			TxState;						// see j1939.c
+	u8_t			Reply;						// CTS or EoMA to send to the sender, 0 for none
+	u8_t			N_A[1];						// not used
+	u32_t			Pgn;							// PGN of the message
+	u32_t			TxDue;						// TIMER_GetUs() of the next BAM packet
+	u32_t			Tick;							// SCHED_Tick of the last progress
+} J1939_Session_t;
+
+
+// sessions with a message, J1939_Poll() skips the walk without one
+extern volatile u8_t  J1939_Active;
+
+
+
+// J1939_Pgn()
+// PGN of an Id, the destination address of PDU1 cleared
+static inline u32_t  J1939_Pgn ( u32_t  Id)
+{
+	u32_t  pgn;
+
+
+	pgn = ( Id >> 8) & 0x3FFFF;
+
+	if ( J1939_PDU1 ( pgn))
+	{
+		pgn &= 0x3FF00;
+	}
+
+	return pgn;
+}
+
+
+
+
+// J1939_Da()
+// destination address of an Id, J1939_GLOBAL for PDU2
+static inline u32_t  J1939_Da ( u32_t  Id)
+{
+	return J1939_PDU1 ( Id >> 8) ? ( Id >> 8) & 0xFF : J1939_GLOBAL;
+}
+
+
+
+
+// J1939_Id()
+// build an Id, Da is ignored for PDU2
+static inline u32_t  J1939_Id ( u32_t  Prio, u32_t  Pgn, u32_t  Da, u32_t  Sa)
+{
+	if ( J1939_PDU1 ( Pgn))
+	{
+		Pgn |= Da;
+	}
+
+	return Prio << 26 | Pgn << 8 | Sa;
+}
+
+
+// j1939 function protos
+
+u32_t  J1939_Rx ( CANHandle_t  hSrc, CANRxMsg_t  *pMsg);
+
+
+void  J1939_Pump ( void);
+
+
+void  J1939_Init ( void);
+
+
+
+// J1939_Poll()
+// called from the main loop, sends what is due
+static inline void  J1939_Poll ( void)
+{
+	if ( J1939_Active)
+	{
+		J1939_Pump();
+	}
+}
+
+
+#endif
@@ -0,0 +1,103 @@
+
+#include "datatypes.h"
+#include "can.h"
+#include "hardware.h"
+#include "led.h"
+#include "stats.h"
+#include "load.h"
+#include "sched.h"
+
+
+// STAT_Bus[].Rx seen by the last LED_Task()
+static u32_t  LED_LastRx[2];
+
+// color set, HW_SetLED() is only called on a change
+static u8_t  LED_Color[2];
+
+// blink phase, toggled every period
+static u8_t  LED_Phase;
+
+
+
+// LED_Set()
+// set the LED of a bus
+static void  LED_Set ( CANHandle_t  hBus, u8_t  Color)
+{
+	if ( LED_Color[hBus] != Color)
+	{
+		LED_Color[hBus] = Color;
+		HW_SetLED ( HW_LED_CAN1 + hBus, Color);
+	}
+}
+
+
+
+
+// LED_Update()
+// choose the color of a bus from its error state and the messages
+// received since the last period
+static void  LED_Update ( CANHandle_t  hBus)
+{
+	u32_t  rx, n, err;
+	
+	
+	rx  = STAT_Bus[hBus].Rx;
+	n   = rx - LED_LastRx[hBus];
+	err = STAT_GetErrState ( hBus);
+	
+	LED_LastRx[hBus] = rx;
+	
+	if ( err & STAT_ERR_BUSOFF)
+	{
+		LED_Set ( hBus, HW_LED_RED);
+	}
+	
+	else if ( err & STAT_ERR_PASSIVE)
+	{
+		LED_Set ( hBus, LED_Phase ? HW_LED_RED : HW_LED_OFF);
+	}
+	
+	else if ( LOAD_Get ( hBus, LOAD_WIN_100MS) >= LED_HIGH_LOAD)
+	{
+		LED_Set ( hBus, HW_LED_ORANGE);
+	}
+	
+	else if ( n > 0)
+	{
+		LED_Set ( hBus, LED_Phase ? HW_LED_ORANGE : HW_LED_GREEN);
+	}
+	
+	else
+	{
+		LED_Set ( hBus, HW_LED_GREEN);
+	}
+}
+
+
+
+
+// LED_Task()
+// scheduled every LED_PERIOD_MS
+static void  LED_Task ( void)
+{
+	LED_Phase ^= 1;
+	
+	LED_Update ( CAN_BUS1);
+	LED_Update ( CAN_BUS2);
+}
+
+
+
+
+// LED_Init()
+// switch the CAN LEDs to green and register the update task
+void  LED_Init ( void)
+{
+	LED_Color[CAN_BUS1] = HW_LED_GREEN;
+	LED_Color[CAN_BUS2] = HW_LED_GREEN;
+	
+	HW_SetLED ( HW_LED_CAN1, HW_LED_GREEN);
+	HW_SetLED ( HW_LED_CAN2, HW_LED_GREEN);
+	
+	SCHED_Add ( LED_Task, LED_PERIOD_MS, LED_PERIOD_MS, LED_PERIOD_MS);
+}
@@ -0,0 +1,31 @@
+
+#ifndef  _LED_H_
+#define  _LED_H_
+
+
+// The CAN LEDs show the state of their bus. The forwarding path doesn't
+// touch them, LED_Task() derives the activity from STAT_Bus[].Rx.
+//	green				idle
+//	green/orange	blinking, messages received
+//	orange			high load over 100 ms, see load.h
+//	red/off			blinking, error passive
+//	red				bus off
+
+
+// LED update period
+#ifndef  LED_PERIOD_MS
+#define  LED_PERIOD_MS			50
+#endif
+
+// High load in permille
+#ifndef  LED_HIGH_LOAD
+#define  LED_HIGH_LOAD			700
+#endif
+
+
+// led function protos
+
+void  LED_Init ( void);
+
+
+#endif
@@ -0,0 +1,164 @@
+
+#include "datatypes.h"
+#include "lpc21xx.h"
+#include "can.h"
+#include "can_user.h"
+#include "load.h"
+#include "sched.h"
+#include "timer.h"
+
+
+// LOAD_Task() period and the slots of the longer windows
+#define  LOAD_PERIOD_MS		10
+#define  LOAD_SLOTS			10
+
+
+// Bits of a frame: SOF, arbitration, control, data, CRC, ACK, EOF and
+// the interframe space. Stuffing covers SOF to CRC, in the worst case
+// one stuff bit after the first 5 bits and after every 4 bits then.
+#define  LOAD_STUFFED(ext,len)	( ( ext) ? 54 + 8 * ( len) : 34 + 8 * ( len))
+#define  LOAD_BITS(ext,len)		( LOAD_STUFFED ( ext, len) + 13 + \
+												LOAD_STUFFING * ( ( LOAD_STUFFED ( ext, len) - 1) / 4))
+
+// a row for each Type & 3, remote frames have no data field
+#define  LOAD_ROW(ext,rtr)		{ \
+	LOAD_BITS ( ext, 0), LOAD_BITS ( ext, rtr ? 0 : 1), LOAD_BITS ( ext, rtr ? 0 : 2), \
+	LOAD_BITS ( ext, rtr ? 0 : 3), LOAD_BITS ( ext, rtr ? 0 : 4), LOAD_BITS ( ext, rtr ? 0 : 5), \
+	LOAD_BITS ( ext, rtr ? 0 : 6), LOAD_BITS ( ext, rtr ? 0 : 7), LOAD_BITS ( ext, rtr ? 0 : 8), \
+	LOAD_BITS ( ext, rtr ? 0 : 8), LOAD_BITS ( ext, rtr ? 0 : 8), LOAD_BITS ( ext, rtr ? 0 : 8), \
+	LOAD_BITS ( ext, rtr ? 0 : 8), LOAD_BITS ( ext, rtr ? 0 : 8), LOAD_BITS ( ext, rtr ? 0 : 8), \
+	LOAD_BITS ( ext, rtr ? 0 : 8)}
+
+const u8_t  LOAD_FrameBits[4][16] = {
+
+	LOAD_ROW ( 0, 0),											// CAN_MSG_STANDARD
+	LOAD_ROW ( 0, 1),											// CAN_MSG_RTR
+	LOAD_ROW ( 1, 0),											// CAN_MSG_EXTENDED
+	LOAD_ROW ( 1, 1)											// CAN_MSG_EXTENDED | CAN_MSG_RTR
+};
+
+
+volatile u32_t  LOAD_Bits[2];
+
+
+typedef struct {
+
+	u32_t			Last;							// LOAD_Bits[] at the last period
+	u32_t			PerPeriod;					// bit rate * LOAD_PERIOD_MS
+	
+	u16_t			Short[LOAD_SLOTS];		// bits per 10 ms
+	u32_t			Long[LOAD_SLOTS];			// bits per 100 ms
+	
+	u32_t			SumShort;					// sum of Short[]
+	u32_t			SumLong;						// sum of Long[]
+	
+	u16_t			Load[LOAD_WIN_COUNT];	// permille
+} LOAD_Bus_t;
+
+static LOAD_Bus_t  LOAD_Bus[2];
+
+static u8_t  LOAD_Slot;							// next Short[] slot
+static u8_t  LOAD_LongSlot;						// next Long[] slot
+
+
+
+// LOAD_Update()
+// close the 10 ms period of a bus
+static void  LOAD_Update ( CANHandle_t  hBus)
+{
+	LOAD_Bus_t  *pB;
+	u32_t  bits, now;
+	
+	
+	pB   = &LOAD_Bus[hBus];
+	now  = LOAD_Bits[hBus];
+	bits = now - pB->Last;
+	
+	pB->Last = now;
+	
+	// a late period holds more than 10 ms, keep it within Short[]
+	if ( bits > pB->PerPeriod * 2)
+	{
+		bits = pB->PerPeriod * 2;
+	}
+	
+	pB->SumShort += bits - pB->Short[LOAD_Slot];
+	pB->Short[LOAD_Slot] = bits;
+	
+	pB->Load[LOAD_WIN_10MS]  = bits * 1000 / pB->PerPeriod;
+	pB->Load[LOAD_WIN_100MS] = pB->SumShort * 1000 / ( pB->PerPeriod * LOAD_SLOTS);
+	
+	if ( pB->Load[LOAD_WIN_100MS] > pB->Load[LOAD_WIN_PEAK])
+	{
+		pB->Load[LOAD_WIN_PEAK] = pB->Load[LOAD_WIN_100MS];
+	}
+	
+	// every 100 ms
+	if ( LOAD_Slot == LOAD_SLOTS - 1)
+	{
+		pB->SumLong += pB->SumShort - pB->Long[LOAD_LongSlot];
+		pB->Long[LOAD_LongSlot] = pB->SumShort;
+		
+		pB->Load[LOAD_WIN_1S] = pB->SumLong * 1000 / ( pB->PerPeriod * LOAD_SLOTS * LOAD_SLOTS);
+	}
+}
+
+
+
+
+// LOAD_Task()
+// scheduled every LOAD_PERIOD_MS
+static void  LOAD_Task ( void)
+{
+	LOAD_Update ( CAN_BUS1);
+	LOAD_Update ( CAN_BUS2);
+	
+	if ( ++LOAD_Slot == LOAD_SLOTS)
+	{
+		LOAD_Slot = 0;
+		
+		if ( ++LOAD_LongSlot == LOAD_SLOTS)
+		{
+			LOAD_LongSlot = 0;
+		}
+	}
+}
+
+
+
+
+// LOAD_Get()
+// load of a bus in permille, Window is one of LOAD_WIN_...
+u32_t  LOAD_Get ( CANHandle_t  hBus, u32_t  Window)
+{
+	if ( Window >= LOAD_WIN_COUNT)
+	{
+		return 0;
+	}
+	
+	return LOAD_Bus[hBus].Load[Window];
+}
+
+
+
+
+// LOAD_ClearPeak()
+// restart the peak load of both busses
+void  LOAD_ClearPeak ( void)
+{
+	LOAD_Bus[CAN_BUS1].Load[LOAD_WIN_PEAK] = 0;
+	LOAD_Bus[CAN_BUS2].Load[LOAD_WIN_PEAK] = 0;
+}
+
+
+
+
+// LOAD_Init()
+// take the bit rates from can_user.h and register the task
+void  LOAD_Init ( void)
+{
+	LOAD_Bus[CAN_BUS1].PerPeriod = CAN_BAUD_BITRATE ( CAN_USER_BAUD_CAN1) / ( 1000 / LOAD_PERIOD_MS);
+	LOAD_Bus[CAN_BUS2].PerPeriod = CAN_BAUD_BITRATE ( CAN_USER_BAUD_CAN2) / ( 1000 / LOAD_PERIOD_MS);
+	
+	SCHED_Add ( LOAD_Task, LOAD_PERIOD_MS, LOAD_PERIOD_MS, LOAD_PERIOD_MS);
+}
@@ -0,0 +1,56 @@
+
+#ifndef  _LOAD_H_
+#define  _LOAD_H_
+
+
+// Bus load meter. Every message received or sent adds its length on the
+// wire to LOAD_Bits[], LOAD_Task() turns that into the load of the last
+// 10 ms, 100 ms and 1 s against the bit rate of the bus. Received
+// messages are counted when the router takes them, so messages the
+// acceptance filter drops are not seen. With filters in use the load of
+// a bus is a lower bound, the load caused by the router is exact.
+
+
+// Stuff bits, 0 to count the frame without them, 1 for the worst case
+#ifndef  LOAD_STUFFING
+#define  LOAD_STUFFING			1
+#endif
+
+
+// windows, see LOAD_Get()
+#define  LOAD_WIN_10MS			0
+#define  LOAD_WIN_100MS		1
+#define  LOAD_WIN_1S			2
+#define  LOAD_WIN_PEAK			3			// highest 100 ms load since LOAD_ClearPeak()
+#define  LOAD_WIN_COUNT		4
+
+
+// bits on the wire per frame, indexed by Type & 3 and Len & 15
+extern const u8_t  LOAD_FrameBits[4][16];
+
+// bits on the wire so far
+extern volatile u32_t  LOAD_Bits[2];
+
+
+
+// LOAD_Count()
+// count a message on the wire of hBus. Called with CAN_UserLock() held
+// or on interrupt level.
+static inline void  LOAD_Count ( CANHandle_t  hBus, u32_t  Type, u32_t  Len)
+{
+	LOAD_Bits[hBus] += LOAD_FrameBits[Type & 3][Len & 15];
+}
+
+
+// load function protos
+
+void  LOAD_Init ( void);
+
+
+u32_t  LOAD_Get ( CANHandle_t  hBus, u32_t  Window);
+
+
+void  LOAD_ClearPeak ( void);
+
+
+#endif
@@ -1,149 +1,212 @@
-
-#include "datatypes.h"
-#include "can.h"
-#include "can_user.h"
-#include "hardware.h"
-#include "crc_data.h"
-
-
-// identifier is needed by PCANFlash.exe -> do not delete
-const b8_t Ident[] __attribute__ ((used)) = { "PCAN-Router"};
-
-
-// info data for PCANFlash.exe
-const crc_array_t  C2F_Array __attribute__((section(".C2F_Info"), used)) = {
-
-	.Str = CRC_IDENT_STRING,
-	.Version = 0x21,
-	.Day = 5,
-	.Month = 5,
-	.Year = 6,
-	.Mode = 1,
-
-	// crc infos are patched during link time by flash.ld
-	// crc value is patched by PCANFlash.exe
-};
-
-
-// variables for LED toggle
-static u8_t LED_toggleCAN1;
-static u8_t LED_toggleCAN2;
-
-
-
-// main_greeting()
-// transmitt a message at module start
-static void  main_greeting ( void)
-{
-	CANMsg_t  Msg;
-	
-
-	Msg.Id   = 0x123;
-	Msg.Len  = 8;
-	Msg.Type = CAN_MSG_STANDARD;
-	
-	Msg.Data32[0] = 0x67452301;
-	Msg.Data32[1] = 0xEFCDAB89;
-	
-	// Send Msg
-	CAN_UserWrite ( CAN_BUS1, &Msg);
-}
-
-
-
-
-// main()
-// entry point from crt0.S
-int  main ( void)
-{
-
-	// init hardware
-	HW_Init();
-	
-	
-	// init CAN
-	CAN_UserInit();
-	
-	
-	// Set green LEDs for CAN1 and CAN2
-	HW_SetLED ( HW_LED_CAN1, HW_LED_GREEN);
-	HW_SetLED ( HW_LED_CAN2, HW_LED_GREEN);
-	
-	
-	// send the greeting message
-	//main_greeting();
-	
-	
-	// main loop
-	while ( 1)
-	{
-		CANMsg_t  RxMsg, TxMsg;
-		
-
-		// process messages from CAN1  
-		if ( CAN_UserRead ( CAN_BUS1, &RxMsg) != 0)
-		{
-			if ( RxMsg.Id != 0x2E4  &&  RxMsg.Type == CAN_MSG_STANDARD)
-			{
-				// message received from CAN1
-				LED_toggleCAN1 ^= 1;
-
-				if ( LED_toggleCAN1)
-				{
-					HW_SetLED ( HW_LED_CAN1, HW_LED_ORANGE);
-				}
-			
-				else
-				{
-					HW_SetLED ( HW_LED_CAN1, HW_LED_GREEN);
-				}
-			
-			
-				// copy message
-				TxMsg.Id   = RxMsg.Id;
-				TxMsg.Type = RxMsg.Type;
-				TxMsg.Len  = RxMsg.Len;
-			
-				TxMsg.Data32[0]	= RxMsg.Data32[0];
-				TxMsg.Data32[1]	= RxMsg.Data32[1];
-				
-				// send
-				CAN_UserWrite ( CAN_BUS2, &TxMsg);
-			}
-		}
-
-
-
-		// process messages from CAN2
-		if ( CAN_UserRead ( CAN_BUS2, &RxMsg) != 0)
-		{
-			if ( RxMsg.Id != 0x2E4  &&  RxMsg.Type == CAN_MSG_STANDARD)
-			{
-			// message received from CAN2
-			LED_toggleCAN2 ^= 1;
-
-			if ( LED_toggleCAN2)
-			{
-				HW_SetLED ( HW_LED_CAN2, HW_LED_ORANGE);
-			}
-			
-			else
-			{
-				HW_SetLED ( HW_LED_CAN2, HW_LED_GREEN);
-			}
-			
-			
-			// copy message
-			TxMsg.Id   = RxMsg.Id;
-			TxMsg.Type = RxMsg.Type;
-			TxMsg.Len  = RxMsg.Len;
-			
-			TxMsg.Data32[0]	= RxMsg.Data32[0];
-			TxMsg.Data32[1]	= RxMsg.Data32[1];
-			
-			// send
-			CAN_UserWrite ( CAN_BUS1, &TxMsg);
-			}
-		}
-	}
-}
+
+#include "datatypes.h"
+#include "lpc21xx.h"
+#include "can.h"
+#include "can_user.h"
+#include "router.h"
+#include "diag.h"
+#include "stats.h"
+#include "timer.h"
+#include "sched.h"
+#include "led.h"
+#include "load.h"
+#include "busoff.h"
+#include "isotp.h"
+#include "j1939.h"
+#include "hardware.h"
+#include "crc_data.h"
+
+
+// identifier is needed by PCANFlash.exe -> do not delete
+const b8_t Ident[] __attribute__ ((used)) = { "PCAN-Router"};
+
+
+// info data for PCANFlash.exe
+const crc_array_t  C2F_Array __attribute__((section(".C2F_Info"), used)) = {
+
+	.Str = CRC_IDENT_STRING,
+	.Version = 0x21,
+	.Day = 5,
+	.Month = 5,
+	.Year = 6,
+	.Mode = 1,
+
+	// crc infos are patched during link time by flash.ld
+	// crc value is patched by PCANFlash.exe
+};
+
+
+// Messages drained per bus and pass of the main loop. The ratio
+// weights the busses, a burst on one bus can't starve the other.
+#ifndef  MAIN_BUDGET_CAN1
+#define  MAIN_BUDGET_CAN1	8
+#endif
+
+#ifndef  MAIN_BUDGET_CAN2
+#define  MAIN_BUDGET_CAN2	8
+#endif
+
+#define  MAIN_BUDGET_MAX	( MAIN_BUDGET_CAN1 > MAIN_BUDGET_CAN2 ? MAIN_BUDGET_CAN1 : MAIN_BUDGET_CAN2)
+
+
+// Non-empty passes per bus, indexed by the number of messages handled in
+// the pass. Read them with the debugger to tune the budgets against burst
+// traces, a high count at the budget index means the budget is too low.
+u32_t  main_PassFrames[2][MAIN_BUDGET_MAX + 1];
+
+
+// Flash access time for the MAM, one CCLK per started 20 MHz, so 3 at
+// 60 MHz. crt0.S runs PCLK at CCLK.
+#define  MAIN_MAMTIM		( ( TIMER_PCLK + 19999999) / 20000000)
+
+
+// main_greeting()
+// transmitt a message at module start
+static void  main_greeting ( void)
+{
+	CANMsg_t  Msg;
+	
+
+	Msg.Id   = 0x123;
+	Msg.Len  = 8;
+	Msg.Type = CAN_MSG_STANDARD;
+	
+	Msg.Data32[0] = 0x67452301;
+	Msg.Data32[1] = 0xEFCDAB89;
+	
+	// Send Msg, a full Tx queue is counted in STAT_Bus[].TxDrop
+	CAN_UserWrite ( CAN_BUS1, &Msg, CAN_USER_NO_DEADLINE);
+}
+
+
+
+
+// main_CheckMAM()
+// make sure the MAM is fully enabled with the fastest flash timing, the
+// code not in .fastrun and the const tables are fetched through it
+static void  main_CheckMAM ( void)
+{
+	if ( MAMCR != 2  ||  MAMTIM != MAIN_MAMTIM)
+	{
+		// MAMTIM may only change with the MAM off
+		MAMCR  = 0;
+		MAMTIM = MAIN_MAMTIM;
+		MAMCR  = 2;
+	}
+}
+
+
+
+
+// main_Drain()
+// process up to Budget messages from the Rx queue of hSrc. Stops early
+// when the queue is empty or a destination Tx queue is full, in that
+// case the message stays queued for the next pass.
+RAMFUNC static u32_t  main_Drain ( CANHandle_t  hSrc, u32_t  Budget)
+{
+	CANRxMsg_t  *pMsg;
+	u32_t  n, ret, lock;
+	
+	
+	for ( n = 0; n < Budget; n++)
+	{
+		pMsg = CAN_UserPeek ( hSrc);
+		
+		if ( pMsg == NULL)
+		{
+			break;
+		}
+		
+		lock = CAN_UserLock();
+		ret = ROUTE_Process ( hSrc, pMsg);
+		CAN_UserUnlock ( lock);
+		
+		if ( ret == ROUTE_RETRY)
+		{
+			// destination full, retry next pass
+			break;
+		}
+		
+		CAN_UserRelease ( hSrc);
+	}
+	
+	if ( n > 0)
+	{
+		main_PassFrames[hSrc][n]++;
+	}
+	
+	return n;
+}
+
+
+
+
+// main()
+// entry point from crt0.S
+int  main ( void)
+{
+	u32_t  last;
+	
+
+	// init hardware
+	HW_Init();
+	main_CheckMAM();
+	
+	
+	// init time base, scheduler, routing tables and CAN
+	TIMER_Init();
+	SCHED_Init();
+	
+	if ( !ROUTE_Init())
+	{
+		// a 29 bit or PGN table of router_cfg.c is not sorted, the
+		// busses stay off and the status LED shows the error
+		HW_SetLED ( HW_LED_STATUS, HW_LED_RED);
+		
+		while ( 1);
+	}
+	
+	// bus off recovery before the callbacks of CAN_UserInit() can run
+	BUSOFF_Init();
+	CAN_UserInit();
+	
+	
+	// work besides forwarding, run by SCHED_Run()
+	SCHED_Add ( STAT_Poll, 1, 1, 10);
+	LOAD_Init();
+	ISOTP_Init();
+	J1939_Init();
+	DIAG_Init();
+	
+	
+	// CAN LEDs, updated by a scheduled task
+	LED_Init();
+	
+	
+	// send the greeting message
+	//main_greeting();
+	
+	
+	// main loop
+	last = TIMER_GetUs();
+	
+	while ( 1)
+	{
+		u32_t  now, n;
+		
+		
+		CAN_UserTxTask();
+		ISOTP_Poll();
+		J1939_Poll();
+		
+		n  = main_Drain ( CAN_BUS1, MAIN_BUDGET_CAN1);
+		n += main_Drain ( CAN_BUS2, MAIN_BUDGET_CAN2);
+		
+		// one scheduled task, held back while there is traffic
+		SCHED_Run ( n == 0);
+		
+		now = TIMER_GetUs();
+		STAT_Sample ( STAT_HIST_LOOP, now - last);
+		last = now;
+	}
+}
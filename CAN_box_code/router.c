@@ -0,0 +1,864 @@
+
+#include "datatypes.h"
+#include "lpc21xx.h"
+#include "can.h"
+#include "can_user.h"
+#include "router.h"
+#include "diag.h"
+#include "stats.h"
+#include "timer.h"
+#include "busoff.h"
+#include "isotp.h"
+#include "j1939.h"
+
+
+// the other bus of the two bus router
+#define  ROUTE_OTHER_BUS(hBus)		( ( hBus) ^ 1)
+
+
+// latency per destination bus
+ROUTE_Latency_t  ROUTE_Latency[2];
+
+
+// acceptance filter entries built by ROUTE_FilterPass()
+typedef struct {
+
+	u32_t			StdSingle;					// 11 bit Ids, two per word
+	u32_t			StdRange;					// 11 bit ranges, one word each
+	u32_t			ExtSingle;					// 29 bit Ids, one word each
+	u32_t			ExtRange;					// 29 bit ranges, two words each
+	u32_t			Add;							// write entries to the filter
+	u32_t			Fail;							// CAN_FilterAddId() failed
+} ROUTE_Filter_t;
+
+
+
+// ROUTE_LimitCheck()
+// refill the bucket of a rate limit and decide if a message may pass.
+// A message dropped by the decimation is counted here, one which passes
+// only by ROUTE_LimitTake(), so a retry doesn't count it twice.
+RAMFUNC static u32_t  ROUTE_LimitCheck ( u32_t  Limit)
+{
+	const ROUTE_Limit_t  *pL;
+	ROUTE_LimitState_t  *pS;
+	u32_t  now, elapsed, full;
+	
+	
+	pL = &ROUTE_Limits[Limit];
+	pS = &ROUTE_LimitState[Limit];
+	
+	if ( pL->M  &&  pS->Count >= pL->N)
+	{
+		if ( ++pS->Count >= pL->M)
+		{
+			pS->Count = 0;
+		}
+		
+		return 0;
+	}
+	
+	if ( pL->PeriodUs)
+	{
+		now     = TIMER_GetUs();
+		elapsed = now - pS->Last;
+		full    = pL->Burst * pL->PeriodUs;
+		
+		pS->Last = now;
+		
+		if ( elapsed >= full - pS->Credit)
+		{
+			pS->Credit = full;
+		}
+		
+		else
+		{
+			pS->Credit += elapsed;
+		}
+		
+		if ( pS->Credit < pL->PeriodUs)
+		{
+			return 0;
+		}
+	}
+	
+	return 1;
+}
+
+
+
+
+// ROUTE_LimitTake()
+// count a message which passed ROUTE_LimitCheck()
+RAMFUNC static void  ROUTE_LimitTake ( u32_t  Limit)
+{
+	const ROUTE_Limit_t  *pL;
+	ROUTE_LimitState_t  *pS;
+	
+	
+	pL = &ROUTE_Limits[Limit];
+	pS = &ROUTE_LimitState[Limit];
+	
+	if ( pL->M  &&  ++pS->Count >= pL->M)
+	{
+		pS->Count = 0;
+	}
+	
+	pS->Credit -= pL->PeriodUs;
+}
+
+
+
+
+// ROUTE_DedupSame()
+// returns 1 when a message carries the data last forwarded from its
+// slot and the refresh interval hasn't passed
+RAMFUNC static u32_t  ROUTE_DedupSame ( u32_t  Dedup, CANRxMsg_t  *pMsg)
+{
+	ROUTE_DedupState_t  *pS;
+	
+	
+	pS = &ROUTE_DedupState[Dedup];
+	
+	return pS->Data32[0] == pMsg->Data32[0]  &&
+			pS->Data32[1] == pMsg->Data32[1]  &&
+			pS->Len == pMsg->Len  &&
+			TIMER_GetUs() - pS->Sent < ROUTE_Dedups[Dedup].RefreshUs;
+}
+
+
+
+
+// ROUTE_DedupStore()
+// remember a forwarded message
+RAMFUNC static void  ROUTE_DedupStore ( u32_t  Dedup, CANRxMsg_t  *pMsg)
+{
+	ROUTE_DedupState_t  *pS;
+	
+	
+	pS = &ROUTE_DedupState[Dedup];
+	
+	pS->Data32[0] = pMsg->Data32[0];
+	pS->Data32[1] = pMsg->Data32[1];
+	pS->Len       = pMsg->Len;
+	pS->Sent      = TIMER_GetUs();
+}
+
+
+
+
+// ROUTE_Search()
+// returns the entry with Key in a table sorted by Id, NULL for none
+RAMFUNC static const ROUTE_ExtEntry_t*  ROUTE_Search ( const ROUTE_ExtEntry_t  *pExt, u32_t  Count, u32_t  Key)
+{
+	u32_t  lo, hi, mid;
+	
+	
+	lo = 0;
+	hi = Count;
+	
+	while ( lo < hi)
+	{
+		mid = ( lo + hi) >> 1;
+		
+		if ( pExt[mid].Id < Key)
+		{
+			lo = mid + 1;
+		}
+		
+		else
+		{
+			hi = mid;
+		}
+	}
+	
+	if ( lo < Count  &&  pExt[lo].Id == Key)
+	{
+		return &pExt[lo];
+	}
+	
+	return NULL;
+}
+
+
+
+
+// ROUTE_RtrStore()
+// remember the data frame of an RTR slot
+RAMFUNC static void  ROUTE_RtrStore ( u32_t  Rtr, CANRxMsg_t  *pMsg)
+{
+	ROUTE_RtrState_t  *pS;
+	
+	
+	pS = &ROUTE_RtrState[Rtr];
+	
+	pS->Data32[0] = pMsg->Data32[0];
+	pS->Data32[1] = pMsg->Data32[1];
+	pS->Len       = pMsg->Len;
+	pS->Seen      = pMsg->TimeStamp32;
+}
+
+
+
+
+// ROUTE_RtrFresh()
+// returns 1 when an RTR slot can answer a remote frame. The age counts
+// to the Rx timestamp of the request, the timer isn't read.
+RAMFUNC static u32_t  ROUTE_RtrFresh ( u32_t  Rtr, CANRxMsg_t  *pMsg)
+{
+	ROUTE_RtrState_t  *pS;
+	
+	
+	pS = &ROUTE_RtrState[Rtr];
+	
+	return pS->Len != ROUTE_RTR_EMPTY  &&  pMsg->TimeStamp32 - pS->Seen < ROUTE_Rtrs[Rtr].MaxAgeUs;
+}
+
+
+
+
+// ROUTE_FindExt()
+// returns the rule index for a 29 bit Id. The Id table comes first,
+// then the PGN table of a J1939 bus.
+RAMFUNC static u8_t  ROUTE_FindExt ( CANHandle_t  hSrc, u32_t  Id)
+{
+	const ROUTE_Table_t  *pTable;
+	const ROUTE_ExtEntry_t  *pE;
+	
+	
+	pTable = &ROUTE_Tables[hSrc];
+	
+	pE = ROUTE_Search ( pTable->pExt, pTable->ExtCount, Id);
+	
+	if ( pE == NULL  &&  pTable->PgnCount)
+	{
+		pE = ROUTE_Search ( pTable->pPgn, pTable->PgnCount, J1939_Pgn ( Id));
+	}
+	
+	if ( pE != NULL)
+	{
+		return pE->Rule;
+	}
+	
+	return pTable->ExtDefault;
+}
+
+
+
+
+// ROUTE_Lookup()
+// returns the rule for a message received on hSrc. 11 bit Ids are a
+// single table access, 29 bit Ids one or two binary searches.
+RAMFUNC const ROUTE_Rule_t*  ROUTE_Lookup ( CANHandle_t  hSrc, CANRxMsg_t  *pMsg)
+{
+	u8_t  rule;
+	
+	
+	if ( pMsg->Type & CAN_MSG_EXTENDED)
+	{
+		rule = ROUTE_FindExt ( hSrc, pMsg->Id);
+	}
+	
+	else
+	{
+		rule = ROUTE_Tables[hSrc].pStd[pMsg->Id & ( ROUTE_STD_IDS - 1)];
+	}
+	
+	return &ROUTE_Rules[rule];
+}
+
+
+
+
+// ROUTE_Measure()
+// account the time from Rx timestamp to Tx commit
+RAMFUNC static void  ROUTE_Measure ( CANHandle_t  hDst, CANRxMsg_t  *pMsg)
+{
+	ROUTE_Latency_t  *pLat;
+	u32_t  us;
+	
+	
+	us   = TIMER_GetUs() - pMsg->TimeStamp32;
+	pLat = &ROUTE_Latency[hDst];
+	
+	if ( pLat->Count == 0  ||  us < pLat->Min)
+	{
+		pLat->Min = us;
+	}
+	
+	if ( us > pLat->Max)
+	{
+		pLat->Max = us;
+	}
+	
+	pLat->Last = us;
+	pLat->Sum += us;
+	pLat->Count++;
+	
+	STAT_Sample ( STAT_HIST_LAT_CAN1 + hDst, us);
+}
+
+
+
+
+// ROUTE_Reserve()
+// returns a Tx slot on hBus for a message with Id and Type, NULL when
+// the Tx queue is full. Applies the policy of the rule. *pStaged is set
+// when the slot is a staged message with the same Id, it is overwritten
+// in place and not committed.
+RAMFUNC static CANMsg_t*  ROUTE_Reserve ( CANHandle_t  hBus, const ROUTE_Rule_t  *pRule, u32_t  Id, u32_t  Type, u32_t  *pStaged)
+{
+	CANMsg_t  *pTx;
+	
+	
+	*pStaged = 0;
+	
+	if ( pRule->Policy == ROUTE_POL_LATEST)
+	{
+		pTx = CAN_UserTxStaged ( hBus, Id, Type);
+		
+		if ( pTx != NULL)
+		{
+			*pStaged = 1;
+			
+			return pTx;
+		}
+	}
+	
+	pTx = CAN_UserTxAlloc ( hBus);
+	
+	if ( pTx == NULL  &&  pRule->Policy >= ROUTE_POL_DROP_OLDEST  &&  CAN_UserTxDropOldest ( hBus))
+	{
+		pTx = CAN_UserTxAlloc ( hBus);
+	}
+	
+	return pTx;
+}
+
+
+
+
+// ROUTE_Due()
+// Tx deadline of a message, from its Rx timestamp and the age limit of
+// the rule
+RAMFUNC static u32_t  ROUTE_Due ( const ROUTE_Rule_t  *pRule, CANRxMsg_t  *pMsg)
+{
+	if ( pRule->MaxAgeMs)
+	{
+		return CAN_UserDeadline ( pMsg->TimeStamp32, pRule->MaxAgeMs * 1000);
+	}
+	
+	return CAN_USER_NO_DEADLINE;
+}
+
+
+
+
+// ROUTE_Send()
+// fill in a slot from ROUTE_Reserve() and send it
+RAMFUNC static void  ROUTE_Send ( CANHandle_t  hBus, const ROUTE_Rule_t  *pRule, CANMsg_t  *pTx, u32_t  Staged, CANRxMsg_t  *pMsg, u32_t  Id, u32_t  Type)
+{
+	u32_t  due;
+	
+	
+	CAN_UserCopy ( pTx, ( CANMsg_t *) pMsg);
+	
+	pTx->Id   = Id;
+	pTx->Type = Type;
+	
+	due = ROUTE_Due ( pRule, pMsg);
+	
+	if ( Staged)
+	{
+		CAN_UserTxRenew ( pTx, due);
+	}
+	
+	else
+	{
+		CAN_UserTxCommit ( hBus, due);
+	}
+	
+	ROUTE_Measure ( hBus, pMsg);
+}
+
+
+
+
+// ROUTE_RtrAnswer()
+// answer a remote frame received on hSrc from the RTR slot of its rule.
+// The policy of the rule applies to the Tx queue of hSrc.
+FLASHFUNC static u32_t  ROUTE_RtrAnswer ( CANHandle_t  hSrc, const ROUTE_Rule_t  *pRule, CANRxMsg_t  *pMsg)
+{
+	ROUTE_RtrState_t  *pS;
+	CANMsg_t  *pTx;
+	u32_t  Type, staged, due;
+	
+	
+	pS   = &ROUTE_RtrState[pRule->Rtr];
+	Type = pMsg->Type & ~CAN_MSG_RTR;
+	pTx  = ROUTE_Reserve ( hSrc, pRule, pMsg->Id, Type, &staged);
+	
+	if ( pTx == NULL)
+	{
+		if ( pRule->Policy == ROUTE_POL_RETRY)
+		{
+			STAT_Bus[hSrc].TxRetry++;
+			
+			return ROUTE_RETRY;
+		}
+		
+		STAT_Bus[hSrc].TxDrop++;
+		
+		return ROUTE_DROPPED;
+	}
+	
+	pTx->Id        = pMsg->Id;
+	pTx->Type      = Type;
+	pTx->Len       = pS->Len;
+	pTx->Data32[0] = pS->Data32[0];
+	pTx->Data32[1] = pS->Data32[1];
+	
+	due = ROUTE_Due ( pRule, pMsg);
+	
+	if ( staged)
+	{
+		CAN_UserTxRenew ( pTx, due);
+	}
+	
+	else
+	{
+		CAN_UserTxCommit ( hSrc, due);
+	}
+	
+	STAT_Bus[hSrc].RtrAnswered++;
+	
+	return ROUTE_LOCAL;
+}
+
+
+
+
+// ROUTE_Process()
+// route a message received on hSrc. Nothing is sent when a destination
+// is full, so the message can be retried later without duplicates.
+// Also called on interrupt level, on main() level the caller holds
+// CAN_UserLock().
+RAMFUNC u32_t  ROUTE_Process ( CANHandle_t  hSrc, CANRxMsg_t  *pMsg)
+{
+	const ROUTE_Rule_t  *pRule;
+	CANMsg_t  *pTx, *pEcho;
+	CANHandle_t  hDst;
+	u32_t  Id, Type, staged, echoStaged;
+	
+	
+	pRule = ROUTE_Lookup ( hSrc, pMsg);
+	
+	if ( pRule->Rtr)
+	{
+		if ( !( pMsg->Type & CAN_MSG_RTR))
+		{
+			ROUTE_RtrStore ( pRule->Rtr, pMsg);
+		}
+		
+		else if ( ROUTE_RtrFresh ( pRule->Rtr, pMsg))
+		{
+			return ROUTE_RtrAnswer ( hSrc, pRule, pMsg);
+		}
+		
+		else if ( !( ROUTE_Rtrs[pRule->Rtr].Flags & ROUTE_RTR_FORWARD))
+		{
+			STAT_Bus[hSrc].Filtered++;
+			
+			return ROUTE_FILTERED;
+		}
+	}
+	
+	// RTR frames are only routed by a rule with an RTR slot
+	else if ( pMsg->Type & CAN_MSG_RTR)
+	{
+		STAT_Bus[hSrc].Filtered++;
+		
+		return ROUTE_FILTERED;
+	}
+	
+	if ( pRule->Action == ROUTE_ACT_DROP)
+	{
+		STAT_Bus[hSrc].Filtered++;
+		
+		return ROUTE_FILTERED;
+	}
+	
+	if ( pRule->Action == ROUTE_ACT_LOCAL)
+	{
+		DIAG_Request ( hSrc, pMsg);
+		STAT_Bus[hSrc].Local++;
+		
+		return ROUTE_LOCAL;
+	}
+	
+	// segmented transfers are relayed by isotp.c, single frames go on
+	if ( pRule->Action == ROUTE_ACT_ISOTP  &&  ISOTP_Rx ( hSrc, pRule->IsoTp, pMsg))
+	{
+		STAT_Bus[hSrc].Local++;
+		
+		return ROUTE_LOCAL;
+	}
+	
+	// J1939 multi-packet messages are relayed by j1939.c
+	if ( pRule->Action == ROUTE_ACT_J1939  &&  J1939_Rx ( hSrc, pMsg))
+	{
+		STAT_Bus[hSrc].Local++;
+		
+		return ROUTE_LOCAL;
+	}
+	
+	hDst = ROUTE_OTHER_BUS ( hSrc);
+	
+	// unchanged messages don't take from the rate limit
+	if ( pRule->Dedup  &&  !( pMsg->Type & CAN_MSG_RTR)  &&  ROUTE_DedupSame ( pRule->Dedup, pMsg))
+	{
+		STAT_Bus[hSrc].Unchanged++;
+		
+		return ROUTE_UNCHANGED;
+	}
+	
+	// stale by the time the bus is back
+	if ( BUSOFF_IsOff ( hDst))
+	{
+		STAT_Bus[hDst].TxDrop++;
+		
+		return ROUTE_DROPPED;
+	}
+	
+	if ( pRule->Limit  &&  !ROUTE_LimitCheck ( pRule->Limit))
+	{
+		STAT_Bus[hSrc].Limited++;
+		
+		return ROUTE_LIMITED;
+	}
+	
+	Id   = pMsg->Id;
+	Type = pMsg->Type;
+	
+	if ( pRule->Action == ROUTE_ACT_REMAP)
+	{
+		Id   = pRule->Id;
+		Type = pRule->Type | ( pMsg->Type & CAN_MSG_RTR);
+	}
+	
+	// reserve all slots first, nothing is committed on a retry
+	pTx = ROUTE_Reserve ( hDst, pRule, Id, Type, &staged);
+	
+	if ( pTx == NULL  &&  pRule->Policy == ROUTE_POL_RETRY)
+	{
+		STAT_Bus[hDst].TxRetry++;
+		
+		return ROUTE_RETRY;
+	}
+	
+	if ( pRule->Action == ROUTE_ACT_BOTH)
+	{
+		// send back on the receiving bus
+		pEcho = ROUTE_Reserve ( hSrc, pRule, pMsg->Id, pMsg->Type, &echoStaged);
+		
+		if ( pEcho == NULL  &&  pRule->Policy == ROUTE_POL_RETRY)
+		{
+			// the slot on hDst must not stay taken until the retry
+			CAN_UserTxCancel ( hDst);
+			
+			STAT_Bus[hSrc].TxRetry++;
+			
+			return ROUTE_RETRY;
+		}
+		
+		if ( pEcho != NULL)
+		{
+			ROUTE_Send ( hSrc, pRule, pEcho, echoStaged, pMsg, pMsg->Id, pMsg->Type);
+		}
+		
+		else
+		{
+			STAT_Bus[hSrc].TxDrop++;
+		}
+	}
+	
+	// past the last retry, the message counts against its limit
+	if ( pRule->Limit)
+	{
+		ROUTE_LimitTake ( pRule->Limit);
+	}
+	
+	if ( pTx == NULL)
+	{
+		STAT_Bus[hDst].TxDrop++;
+		
+		return ROUTE_DROPPED;
+	}
+	
+	ROUTE_Send ( hDst, pRule, pTx, staged, pMsg, Id, Type);
+	
+	if ( pRule->Dedup  &&  !( pMsg->Type & CAN_MSG_RTR))
+	{
+		ROUTE_DedupStore ( pRule->Dedup, pMsg);
+	}
+	
+	STAT_Bus[hSrc].Forwarded++;
+	
+	return ROUTE_SENT;
+}
+
+
+
+
+// ROUTE_FilterId()
+// account for one passed Id or Id range and add it to the filter
+static void  ROUTE_FilterId ( ROUTE_Filter_t  *pF, CANHandle_t  hBus, u32_t  Ext, u32_t  Start, u32_t  End)
+{
+	CANStatus_t  ret;
+	
+	
+	if ( Start == End)
+	{
+		if ( Ext)
+		{
+			pF->ExtSingle++;
+		}
+		
+		else
+		{
+			pF->StdSingle++;
+		}
+		
+		if ( !pF->Add)
+		{
+			return;
+		}
+		
+		ret = CAN_FilterAddId ( hBus, Ext ? FILTER_29BIT_ID : FILTER_11BIT_ID, Start);
+	}
+	
+	else
+	{
+		if ( Ext)
+		{
+			pF->ExtRange++;
+		}
+		
+		else
+		{
+			pF->StdRange++;
+		}
+		
+		if ( !pF->Add)
+		{
+			return;
+		}
+		
+		ret = CAN_FilterAddId ( hBus, Ext ? FILTER_29BIT_ID_RANGE : FILTER_11BIT_ID_RANGE, Start, End);
+	}
+	
+	if ( ret != CAN_ERR_OK)
+	{
+		pF->Fail = 1;
+	}
+}
+
+
+
+
+// ROUTE_FilterRule()
+// returns 1 when the Ids of a rule pass the acceptance filter. A rule
+// which drops still needs its data frames for an RTR slot.
+static u32_t  ROUTE_FilterRule ( u32_t  Rule)
+{
+	return ROUTE_Rules[Rule].Action != ROUTE_ACT_DROP  ||  ROUTE_Rules[Rule].Rtr;
+}
+
+
+
+
+// ROUTE_FilterPass()
+// walk the routing tables and pass every Id that is not dropped. Runs of
+// consecutive Ids become ranges. Returns the filter RAM needed in words.
+static u32_t  ROUTE_FilterPass ( ROUTE_Filter_t  *pF)
+{
+	const ROUTE_Table_t  *pTable;
+	CANHandle_t  hBus;
+	u32_t  id, start, run, i;
+	
+	
+	for ( hBus = CAN_BUS1; hBus <= CAN_BUS2; hBus++)
+	{
+		pTable = &ROUTE_Tables[hBus];
+		
+		// 11 bit Ids
+		run   = 0;
+		start = 0;
+		
+		for ( id = 0; id < ROUTE_STD_IDS; id++)
+		{
+			if ( ROUTE_FilterRule ( pTable->pStd[id]))
+			{
+				if ( !run)
+				{
+					start = id;
+					run   = 1;
+				}
+			}
+			
+			else if ( run)
+			{
+				ROUTE_FilterId ( pF, hBus, 0, start, id - 1);
+				run = 0;
+			}
+		}
+		
+		if ( run)
+		{
+			ROUTE_FilterId ( pF, hBus, 0, start, ROUTE_STD_IDS - 1);
+		}
+		
+		// 29 bit Ids, a passing default or a PGN table needs the full range
+		if ( ROUTE_FilterRule ( pTable->ExtDefault)  ||  pTable->PgnCount)
+		{
+			ROUTE_FilterId ( pF, hBus, 1, 0, 0x1FFFFFFF);
+			continue;
+		}
+		
+		run = 0;
+		
+		for ( i = 0; i < pTable->ExtCount; i++)
+		{
+			id = pTable->pExt[i].Id;
+			
+			if ( !ROUTE_FilterRule ( pTable->pExt[i].Rule))
+			{
+				continue;
+			}
+			
+			if ( run  &&  id == start + run)
+			{
+				run++;
+				continue;
+			}
+			
+			if ( run)
+			{
+				ROUTE_FilterId ( pF, hBus, 1, start, start + run - 1);
+			}
+			
+			start = id;
+			run   = 1;
+		}
+		
+		if ( run)
+		{
+			ROUTE_FilterId ( pF, hBus, 1, start, start + run - 1);
+		}
+	}
+	
+	return ( pF->StdSingle + 1) / 2 + pF->StdRange + pF->ExtSingle + 2 * pF->ExtRange;
+}
+
+
+
+
+// ROUTE_InitFilters()
+// compile the routing tables into the hardware acceptance filter, so
+// dropped Ids never raise an interrupt. When the entries don't fit the
+// filter RAM the filter is bypassed and ROUTE_Process() drops them in
+// software. Returns the filter RAM used in words.
+u32_t  ROUTE_InitFilters ( void)
+{
+	ROUTE_Filter_t  f = { 0};
+	u32_t  words;
+	
+	
+	CAN_InitFilters();										// Clear Filter LUT
+	
+	words = ROUTE_FilterPass ( &f);
+	
+	if ( words <= ROUTE_AF_WORDS)
+	{
+		ROUTE_Filter_t  add = { .Add = 1};
+		
+		ROUTE_FilterPass ( &add);
+		
+		if ( !add.Fail)
+		{
+			CAN_SetFilterMode ( AF_ON);					// Filters from the routing tables
+			
+			return words;
+		}
+		
+		CAN_InitFilters();
+	}
+	
+	CAN_SetFilterMode ( AF_ON_BYPASS_ON);				// No Filters ( Bypassed)
+	
+	return 0;
+}
+
+
+
+
+// ROUTE_Sorted()
+// returns 1 when the Ids of a table ascend strictly
+static u32_t  ROUTE_Sorted ( const ROUTE_ExtEntry_t  *pExt, u32_t  Count)
+{
+	u32_t  i;
+	
+	
+	for ( i = 1; i < Count; i++)
+	{
+		if ( pExt[i - 1].Id >= pExt[i].Id)
+		{
+			return 0;
+		}
+	}
+	
+	return 1;
+}
+
+
+
+
+// ROUTE_Init()
+// check the 29 bit and PGN tables from router_cfg.c, fill the buckets
+// of the rate limits and empty the dedup and RTR slots. Returns 0 when
+// a table is not sorted or holds an Id twice, the binary search would
+// miss entries and the router must not run.
+u32_t  ROUTE_Init ( void)
+{
+	const ROUTE_Table_t  *pTable;
+	CANHandle_t  hBus;
+	u32_t  i;
+	
+	
+	for ( i = 0; i < ROUTE_LimitCount; i++)
+	{
+		ROUTE_LimitState[i].Last   = TIMER_GetUs();
+		ROUTE_LimitState[i].Credit = ROUTE_Limits[i].Burst * ROUTE_Limits[i].PeriodUs;
+	}
+	
+	for ( i = 0; i < ROUTE_DedupCount; i++)
+	{
+		ROUTE_DedupState[i].Len = ROUTE_DEDUP_EMPTY;
+	}
+	
+	for ( i = 0; i < ROUTE_RtrCount; i++)
+	{
+		ROUTE_RtrState[i].Len = ROUTE_RTR_EMPTY;
+	}
+	
+	for ( hBus = CAN_BUS1; hBus <= CAN_BUS2; hBus++)
+	{
+		pTable = &ROUTE_Tables[hBus];
+		
+		if ( !ROUTE_Sorted ( pTable->pExt, pTable->ExtCount)  ||  !ROUTE_Sorted ( pTable->pPgn, pTable->PgnCount))
+		{
+			return 0;
+		}
+	}
+	
+	return 1;
+}
@@ -0,0 +1,197 @@
+
+#ifndef  _ROUTER_H_
+#define  _ROUTER_H_
+
+
+// defines
+#define  ROUTE_STD_IDS		2048			// size of the 11 bit Id tables
+
+
+// acceptance filter RAM of the LPC21xx as 32 bit words
+#define  ROUTE_AF_WORDS		512
+
+
+// route actions
+#define  ROUTE_ACT_DROP			0		// filter message
+#define  ROUTE_ACT_FORWARD		1		// forward to the other bus
+#define  ROUTE_ACT_BOTH			2		// forward to the other and the receiving bus
+#define  ROUTE_ACT_REMAP		3		// forward to the other bus with a new Id
+#define  ROUTE_ACT_LOCAL		4		// request to the router, see diag.h
+#define  ROUTE_ACT_ISOTP		5		// ISO-TP channel, see isotp.h
+#define  ROUTE_ACT_J1939		6		// J1939 transport and address claim, see j1939.h
+
+
+// results of ROUTE_Process()
+#define  ROUTE_FILTERED		0			// message dropped, free it
+#define  ROUTE_SENT				1			// message forwarded, free it
+#define  ROUTE_RETRY			2			// destination full, keep the message
+#define  ROUTE_LOCAL			3			// message taken by the router, free it
+#define  ROUTE_DROPPED			4			// destination full, dropped by the policy, free it
+#define  ROUTE_LIMITED			5			// dropped by the rate limit of the rule, free it
+#define  ROUTE_UNCHANGED		6			// same data as the last one forwarded, free it
+
+
+// policies on a full destination Tx queue
+#define  ROUTE_POL_RETRY			0		// keep the message in the Rx queue, retry later
+#define  ROUTE_POL_DROP_NEWEST	1		// drop the message
+#define  ROUTE_POL_DROP_OLDEST	2		// drop the oldest staged message of the destination
+#define  ROUTE_POL_LATEST			3		// replace a staged message with the same Id, else drop oldest
+
+
+// A routing rule. Rules are referenced by index from the Id tables.
+typedef struct {
+
+	u8_t			Action;						// see ROUTE_ACT_...
+	u8_t			Type;							// new message type for ROUTE_ACT_REMAP
+	u8_t			Policy;						// see ROUTE_POL_...
+	u8_t			Limit;						// index into ROUTE_Limits[], 0 for none
+	u8_t			Dedup;						// index into ROUTE_Dedups[], 0 for none
+	u8_t			IsoTp;						// index into ISOTP_Chans[] for ROUTE_ACT_ISOTP
+	u16_t			MaxAgeMs;					// drop when not sent this long after Rx, 0 for no limit
+	u8_t			Rtr;							// index into ROUTE_Rtrs[], 0 for none
+	u8_t			N_A[3];						// not used
+
+	u32_t			Id;							// new Id for ROUTE_ACT_REMAP
+} ROUTE_Rule_t;
+
+
+// Rate limit of a rule, a token bucket followed by N of M decimation.
+// Both stages are optional. Rules may share a limit, they share its
+// rate then.
+typedef struct {
+
+	u32_t			PeriodUs;					// one message per period, 0 for no bucket
+	u16_t			Burst;						// messages passed back to back
+	u8_t			N;								// pass N ...
+	u8_t			M;								// ... of every M messages, 0 for no decimation
+} ROUTE_Limit_t;
+
+
+// State of a rate limit. The bucket holds microseconds, a message takes
+// PeriodUs out.
+typedef struct {
+
+	u32_t			Last;							// TIMER_GetUs() of the last refill
+	u32_t			Credit;						// up to Burst * PeriodUs
+	u8_t			Count;						// position in the M messages
+	u8_t			N_A[3];						// not used
+} ROUTE_LimitState_t;
+
+
+// Change-only forwarding. A message with the data of the last one
+// forwarded is dropped until RefreshUs have passed, then it goes out
+// anyway. A slot holds the last value of one Id, each deduplicated Id
+// needs a rule of its own.
+typedef struct {
+
+	u32_t			RefreshUs;					// longest time without a forwarded message
+} ROUTE_Dedup_t;
+
+
+// State of a dedup slot
+typedef struct {
+
+	u32_t			Data32[2];					// last forwarded data
+	u32_t			Sent;							// TIMER_GetUs() of the last forward
+	u8_t			Len;							// last forwarded length, ROUTE_DEDUP_EMPTY before
+	u8_t			N_A[3];						// not used
+} ROUTE_DedupState_t;
+
+#define  ROUTE_DEDUP_EMPTY		0xFF
+
+
+// Remote frame proxy. A slot holds the last data frame of one Id, a
+// remote frame for the Id is answered from it on the requesting bus
+// while the data is younger than MaxAgeUs. Without data or with older
+// data the request goes to the other bus with ROUTE_RTR_FORWARD and is
+// dropped without. Remote frames of rules without a slot are dropped.
+typedef struct {
+
+	u32_t			MaxAgeUs;					// oldest data answered from the slot
+	u8_t			Flags;						// see ROUTE_RTR_...
+	u8_t			N_A[3];						// not used
+} ROUTE_Rtr_t;
+
+#define  ROUTE_RTR_FORWARD		1			// forward what the slot can't answer
+
+
+// State of an RTR slot
+typedef struct {
+
+	u32_t			Data32[2];					// data of the last data frame
+	u32_t			Seen;							// its Rx timestamp
+	u8_t			Len;							// its length, ROUTE_RTR_EMPTY before
+	u8_t			N_A[3];						// not used
+} ROUTE_RtrState_t;
+
+#define  ROUTE_RTR_EMPTY			0xFF
+
+
+// 29 bit Id entry
+typedef struct {
+
+	u32_t			Id;							// 29 bit Id
+	u8_t			Rule;							// index into ROUTE_Rules[]
+} ROUTE_ExtEntry_t;
+
+
+// Routing table of a receiving bus. A 29 bit Id not in pExt is looked
+// up by its J1939 PGN in pPgn, the Id field of those entries holds the
+// PGN. A bus with a PGN table takes all 29 bit Ids into the acceptance
+// filter, the PGN isn't a range of Ids. Both tables are searched
+// binary, ROUTE_Init() fails on one not sorted.
+typedef struct {
+
+	const u8_t					*pStd;		// rule index for each 11 bit Id
+	const ROUTE_ExtEntry_t	*pExt;		// 29 bit Ids, sorted ascending
+	u16_t							ExtCount;	// entries in pExt
+	u8_t							ExtDefault;	// rule for 29 bit Ids not in pExt or pPgn
+	const ROUTE_ExtEntry_t	*pPgn;		// PGNs, sorted ascending
+	u16_t							PgnCount;	// entries in pPgn, 0 for no J1939
+} ROUTE_Table_t;
+
+
+// Forwarding latency of a destination bus, from the Rx timestamp to the
+// Tx commit in microseconds
+typedef struct {
+
+	u32_t			Count;						// forwarded messages
+	u32_t			Last;							// latency of the last message
+	u32_t			Min;							// lowest latency
+	u32_t			Max;							// highest latency
+	u64_t			Sum;							// for the average
+} ROUTE_Latency_t;
+
+
+extern ROUTE_Latency_t  ROUTE_Latency[2];
+
+
+// Tables, defined in router_cfg.c
+extern const ROUTE_Rule_t  ROUTE_Rules[];
+extern const ROUTE_Table_t  ROUTE_Tables[2];
+extern const ROUTE_Limit_t  ROUTE_Limits[];
+extern ROUTE_LimitState_t  ROUTE_LimitState[];
+extern const u32_t  ROUTE_LimitCount;
+extern const ROUTE_Dedup_t  ROUTE_Dedups[];
+extern ROUTE_DedupState_t  ROUTE_DedupState[];
+extern const u32_t  ROUTE_DedupCount;
+extern const ROUTE_Rtr_t  ROUTE_Rtrs[];
+extern ROUTE_RtrState_t  ROUTE_RtrState[];
+extern const u32_t  ROUTE_RtrCount;
+
+
+// router function protos, RAMFUNC comes from can_user.h
+
+u32_t  ROUTE_Init ( void);
+
+
+u32_t  ROUTE_InitFilters ( void);
+
+
+RAMFUNC const ROUTE_Rule_t*  ROUTE_Lookup ( CANHandle_t  hSrc, CANRxMsg_t  *pMsg);
+
+
+RAMFUNC u32_t  ROUTE_Process ( CANHandle_t  hSrc, CANRxMsg_t  *pMsg);
+
+
+#endif
@@ -0,0 +1,275 @@
+
+#include "datatypes.h"
+#include "lpc21xx.h"
+#include "can.h"
+#include "can_user.h"
+#include "router.h"
+#include "diag.h"
+#include "isotp.h"
+#include "j1939.h"
+
+
+// 1 = the tables route a few Ids through the example rules below, 0 =
+// plain forwarding between the busses, only the diag service is local
+#ifndef  ROUTE_EXAMPLES
+#define  ROUTE_EXAMPLES			0
+#endif
+
+
+//
+// Gateway configuration. Every Id received on a bus selects a rule by
+// index. Add a rule to ROUTE_Rules[] and reference it from the Id tables,
+// the forwarding code stays untouched. All tables are const and live in
+// ROM.
+//
+// The policy of a rule decides what happens when the destination Tx
+// queue and its share of the spill area are full. ROUTE_POL_RETRY keeps
+// the message and holds up the Rx queue behind it. Cyclic signals should
+// use ROUTE_POL_LATEST, only their newest value is of any use.
+//
+// A rule bridging to a slower bus can take a rate limit from
+// ROUTE_Limits[]. The limit drops what exceeds its rate before the
+// message reaches the Tx queue, the bit timing of the busses is set in
+// can_user.h.
+//
+// Cyclic messages which rarely change can be forwarded on a change only,
+// with a slot from ROUTE_Dedups[]. The slot holds the last value of one
+// Id, so every deduplicated Id needs a rule of its own.
+//
+// Remote frames are dropped unless the rule of their Id has a slot from
+// ROUTE_Rtrs[]. The slot keeps the last data frame of the Id and answers
+// the remote frame on the requesting bus, a round trip over the gateway
+// less. Like a dedup slot it holds one Id, the Id needs the rule with
+// the slot in the tables of both busses.
+//
+// ROUTE_EXAMPLES=1 builds the tables with one Id for each of these
+// paths: the two rate limits, a deadline and a dedup slot on CAN1, an
+// RTR slot, an ISO-TP channel and J1939 on both busses. The default leaves them
+// out, without a channel or a PGN table the ISO-TP and J1939 tasks are
+// not scheduled.
+//
+// Diagnostic sessions with segmented messages go through a channel of
+// ISOTP_Chans[], the Ids of both directions route to a ROUTE_ACT_ISOTP
+// rule for it. The router then handles the flow control on each bus.
+// Each direction of a channel holds one message. A message of up to 4095
+// bytes is taken while no other session holds the pool, beside another
+// one a message gets the share of ISOTP_SHARE_BLOCKS, 2 KB by default. A
+// first frame which doesn't fit is answered with an overflow. See
+// isotp.h for the pool.
+//
+// A J1939 bus routes its 29 bit Ids by PGN from ROUTE_PgnCANx, Ids in
+// ROUTE_ExtCANx still take precedence. The transport and address claim
+// PGNs go to RULE_J1939, multi-packet messages are then relayed with the
+// timing of each bus, see the example entries of ROUTE_PgnCANx.
+//
+
+
+// rate limit indices, 0 is no limit
+enum {
+	LIMIT_NONE = 0,
+#if ROUTE_EXAMPLES
+	LIMIT_100HZ,
+	LIMIT_HALF,
+#endif
+};
+
+
+// rate limits
+const ROUTE_Limit_t  ROUTE_Limits[] = {
+
+	[LIMIT_NONE]		= { 0},
+#if ROUTE_EXAMPLES
+	[LIMIT_100HZ]		= { .PeriodUs = 10000, .Burst = 4},		// 100 messages/s, 4 back to back
+	[LIMIT_HALF]		= { .N = 1, .M = 2},							// every other message
+#endif
+};
+
+const u32_t  ROUTE_LimitCount = sizeof ( ROUTE_Limits) / sizeof ( ROUTE_Limits[0]);
+
+// state, in RAM
+ROUTE_LimitState_t  ROUTE_LimitState[sizeof ( ROUTE_Limits) / sizeof ( ROUTE_Limits[0])];
+
+
+// dedup slot indices, 0 is no dedup
+enum {
+	DEDUP_NONE = 0,
+#if ROUTE_EXAMPLES
+	DEDUP_EXAMPLE,
+#endif
+};
+
+
+// dedup slots
+const ROUTE_Dedup_t  ROUTE_Dedups[] = {
+
+	[DEDUP_NONE]		= { 0},
+#if ROUTE_EXAMPLES
+	[DEDUP_EXAMPLE]	= { .RefreshUs = 1000000},						// at least once a second
+#endif
+};
+
+const u32_t  ROUTE_DedupCount = sizeof ( ROUTE_Dedups) / sizeof ( ROUTE_Dedups[0]);
+
+// state, in RAM
+ROUTE_DedupState_t  ROUTE_DedupState[sizeof ( ROUTE_Dedups) / sizeof ( ROUTE_Dedups[0])];
+
+
+// RTR slot indices, 0 is no slot
+enum {
+	RTR_NONE = 0,
+#if ROUTE_EXAMPLES
+	RTR_EXAMPLE,
+#endif
+};
+
+
+// RTR slots
+const ROUTE_Rtr_t  ROUTE_Rtrs[] = {
+
+	[RTR_NONE]			= { 0},
+#if ROUTE_EXAMPLES
+	[RTR_EXAMPLE]		= { .MaxAgeUs = 100000, .Flags = ROUTE_RTR_FORWARD},		// older than 100 ms asks the other bus
+#endif
+};
+
+const u32_t  ROUTE_RtrCount = sizeof ( ROUTE_Rtrs) / sizeof ( ROUTE_Rtrs[0]);
+
+// state, in RAM
+ROUTE_RtrState_t  ROUTE_RtrState[sizeof ( ROUTE_Rtrs) / sizeof ( ROUTE_Rtrs[0])];
+
+
+// ISO-TP channel indices, 0 is no channel
+enum {
+	ISOTP_NONE = 0,
+#if ROUTE_EXAMPLES
+	ISOTP_EXAMPLE,
+#endif
+};
+
+
+// ISO-TP channels
+const ISOTP_Chan_t  ISOTP_Chans[] = {
+
+	[ISOTP_NONE]		= { { 0}},
+#if ROUTE_EXAMPLES
+	[ISOTP_EXAMPLE]	= { .Id = { 0x7E0, 0x7E8}, .Type = CAN_MSG_STANDARD, .Pad = 0xCC},	// tester on CAN1, ECU on CAN2
+#endif
+};
+
+const u32_t  ISOTP_ChanCount = sizeof ( ISOTP_Chans) / sizeof ( ISOTP_Chans[0]);
+
+// state, in RAM
+ISOTP_Link_t  ISOTP_Links[sizeof ( ISOTP_Chans) / sizeof ( ISOTP_Chans[0])][2];
+
+
+// rule indices
+enum {
+	RULE_DROP = 0,
+	RULE_FORWARD,
+	RULE_DIAG,
+#if ROUTE_EXAMPLES
+	RULE_FORWARD_100HZ,
+	RULE_FORWARD_CHANGED,
+	RULE_FORWARD_20MS,
+	RULE_ISOTP_EXAMPLE,
+	RULE_J1939,
+	RULE_RTR_EXAMPLE,
+	RULE_FORWARD_HALF,
+#endif
+};
+
+
+// rules
+const ROUTE_Rule_t  ROUTE_Rules[] = {
+
+	[RULE_DROP]			= { .Action = ROUTE_ACT_DROP},
+	[RULE_FORWARD]		= { .Action = ROUTE_ACT_FORWARD},
+	[RULE_DIAG]			= { .Action = ROUTE_ACT_LOCAL},
+#if ROUTE_EXAMPLES
+	[RULE_FORWARD_100HZ]	= { .Action = ROUTE_ACT_FORWARD, .Policy = ROUTE_POL_LATEST, .Limit = LIMIT_100HZ},
+	[RULE_FORWARD_CHANGED]	= { .Action = ROUTE_ACT_FORWARD, .Dedup = DEDUP_EXAMPLE},
+	[RULE_FORWARD_20MS]	= { .Action = ROUTE_ACT_FORWARD, .MaxAgeMs = 20},				// late control data is worse than none
+	[RULE_ISOTP_EXAMPLE]	= { .Action = ROUTE_ACT_ISOTP, .IsoTp = ISOTP_EXAMPLE},		// 0x7E0 on CAN1 and 0x7E8 on CAN2
+	[RULE_J1939]			= { .Action = ROUTE_ACT_J1939},										// J1939 transport and address claim
+	[RULE_RTR_EXAMPLE]	= { .Action = ROUTE_ACT_FORWARD, .Rtr = RTR_EXAMPLE},			// data forwarded, remote frames answered
+	[RULE_FORWARD_HALF]	= { .Action = ROUTE_ACT_FORWARD, .Limit = LIMIT_HALF},
+#endif
+};
+
+
+// 11 bit Ids received on CAN1
+static const u8_t  ROUTE_StdCAN1[ROUTE_STD_IDS] = {
+
+	[0 ... ROUTE_STD_IDS - 1]	= RULE_FORWARD,
+	[0x2E4]							= RULE_DROP,
+	[DIAG_REQ_ID]					= RULE_DIAG,
+#if ROUTE_EXAMPLES
+	[0x0A0]							= RULE_FORWARD_20MS,
+	[0x100]							= RULE_FORWARD_100HZ,
+	[0x200]							= RULE_FORWARD_CHANGED,
+	[0x300]							= RULE_RTR_EXAMPLE,
+	[0x7E0]							= RULE_ISOTP_EXAMPLE,
+#endif
+};
+
+
+// 11 bit Ids received on CAN2
+static const u8_t  ROUTE_StdCAN2[ROUTE_STD_IDS] = {
+
+	[0 ... ROUTE_STD_IDS - 1]	= RULE_FORWARD,
+	[0x2E4]							= RULE_DROP,
+	[DIAG_REQ_ID]					= RULE_DIAG,
+#if ROUTE_EXAMPLES
+	[0x300]							= RULE_RTR_EXAMPLE,
+	[0x7E8]							= RULE_ISOTP_EXAMPLE,
+#endif
+};
+
+
+// 29 bit Ids received on CAN1, sorted by Id
+static const ROUTE_ExtEntry_t  ROUTE_ExtCAN1[] = {
+
+#if ROUTE_EXAMPLES
+	{ 0x18FF0010,	RULE_FORWARD_HALF},
+#endif
+};
+
+
+// 29 bit Ids received on CAN2, sorted by Id
+static const ROUTE_ExtEntry_t  ROUTE_ExtCAN2[] = {
+
+};
+
+
+// J1939 PGNs received on CAN1, sorted by PGN
+static const ROUTE_ExtEntry_t  ROUTE_PgnCAN1[] = {
+
+#if ROUTE_EXAMPLES
+	{ J1939_PGN_REQUEST,		RULE_J1939},
+	{ J1939_PGN_TP_DT,		RULE_J1939},
+	{ J1939_PGN_TP_CM,		RULE_J1939},
+	{ J1939_PGN_ADDR_CLAIM,	RULE_J1939},
+#endif
+};
+
+
+// J1939 PGNs received on CAN2, sorted by PGN
+static const ROUTE_ExtEntry_t  ROUTE_PgnCAN2[] = {
+
+#if ROUTE_EXAMPLES
+	{ J1939_PGN_REQUEST,		RULE_J1939},
+	{ J1939_PGN_TP_DT,		RULE_J1939},
+	{ J1939_PGN_TP_CM,		RULE_J1939},
+	{ J1939_PGN_ADDR_CLAIM,	RULE_J1939},
+#endif
+};
+
+
+#define  EXT_COUNT(table)	( sizeof ( table) / sizeof ( table[0]))
+
+
+const ROUTE_Table_t  ROUTE_Tables[2] = {
+
+	[CAN_BUS1] = { ROUTE_StdCAN1, ROUTE_ExtCAN1, EXT_COUNT ( ROUTE_ExtCAN1), RULE_DROP, ROUTE_PgnCAN1, EXT_COUNT ( ROUTE_PgnCAN1)},
+	[CAN_BUS2] = { ROUTE_StdCAN2, ROUTE_ExtCAN2, EXT_COUNT ( ROUTE_ExtCAN2), RULE_DROP, ROUTE_PgnCAN2, EXT_COUNT ( ROUTE_PgnCAN2)},
+};
@@ -0,0 +1,303 @@
+
+#include "datatypes.h"
+#include "lpc21xx.h"
+#include "sched.h"
+#include "timer.h"
+
+
+// Timer0 interrupt in VIC slot 5, below the CAN interrupts
+#define  SCHED_INTSOURCE		4
+
+// The IRQ vector enters in ARM state, a Thumb build keeps the handler ARM
+#if defined ( SIM_HOST)
+#define  SCHED_ISR
+#elif defined ( __thumb__)
+#define  SCHED_ISR				__attribute__ ( ( interrupt ( "IRQ"), target ( "arm")))
+#else
+#define  SCHED_ISR				__attribute__ ( ( interrupt ( "IRQ")))
+#endif
+
+// called before a task runs, the host build counts it as activity
+#ifndef  SCHED_RUN_HOOK
+#define  SCHED_RUN_HOOK()
+#endif
+
+
+// task states
+#define  SCHED_FREE				0
+#define  SCHED_WHEEL				1				// in a wheel slot
+#define  SCHED_READY				2				// due, in the ready list
+
+
+typedef struct {
+
+	SCHED_Func_t	Func;
+	u32_t			Due;								// tick
+	u16_t			Period;							// 0 for a one-shot task
+	u16_t			Slack;							// wait for an idle loop at most this long
+	u8_t			State;
+	u8_t			Next;								// next task in the slot or ready list
+	u8_t			N_A[2];
+} SCHED_Task_t;
+
+
+volatile u32_t  SCHED_Tick;
+
+static SCHED_Task_t  SCHED_Tasks[SCHED_TASKS];
+static u8_t  SCHED_Wheel[SCHED_WHEEL_SIZE];			// list heads
+static u8_t  SCHED_Ready;									// due tasks, in due order
+static u32_t  SCHED_Done;									// last tick moved to the ready list
+
+
+
+// SCHED_Isr()
+// Timer0 match interrupt
+static void  SCHED_Isr ( void) SCHED_ISR;
+static void  SCHED_Isr ( void)
+{
+	T0IR = 1;											// clear MR0
+	SCHED_Tick++;
+	
+	VICVectAddr = 0;
+}
+
+
+
+
+// SCHED_Unlink()
+// remove a task from the list at pHead
+static void  SCHED_Unlink ( u8_t  *pHead, u32_t  Task)
+{
+	while ( *pHead != SCHED_NONE)
+	{
+		if ( *pHead == Task)
+		{
+			*pHead = SCHED_Tasks[Task].Next;
+			return;
+		}
+		
+		pHead = &SCHED_Tasks[*pHead].Next;
+	}
+}
+
+
+
+
+// SCHED_Append()
+// add a task to the end of the ready list
+static void  SCHED_Append ( u32_t  Task)
+{
+	u8_t  *pHead = &SCHED_Ready;
+	
+	
+	while ( *pHead != SCHED_NONE)
+	{
+		pHead = &SCHED_Tasks[*pHead].Next;
+	}
+	
+	SCHED_Tasks[Task].State = SCHED_READY;
+	SCHED_Tasks[Task].Next  = SCHED_NONE;
+	*pHead = Task;
+}
+
+
+
+
+// SCHED_Insert()
+// put a task into the slot of its due tick, or into the ready list if
+// that tick is done
+static void  SCHED_Insert ( u32_t  Task)
+{
+	SCHED_Task_t  *pT = &SCHED_Tasks[Task];
+	u8_t  *pHead;
+	
+	
+	if ( ( s32_t) ( pT->Due - SCHED_Done) <= 0)
+	{
+		SCHED_Append ( Task);
+		return;
+	}
+	
+	pHead = &SCHED_Wheel[pT->Due & ( SCHED_WHEEL_SIZE - 1)];
+	
+	pT->State = SCHED_WHEEL;
+	pT->Next  = *pHead;
+	*pHead    = Task;
+}
+
+
+
+
+// SCHED_Add()
+// add a task, due in DelayMs and then every PeriodMs, or once with
+// PeriodMs 0. Returns the task or SCHED_NONE if all slots are taken.
+// Main level only.
+u32_t  SCHED_Add ( SCHED_Func_t  Func, u32_t  DelayMs, u32_t  PeriodMs, u32_t  SlackMs)
+{
+	u32_t  i;
+	
+	
+	for ( i = 0; i < SCHED_TASKS; i++)
+	{
+		if ( SCHED_Tasks[i].State == SCHED_FREE)
+		{
+			SCHED_Tasks[i].Func   = Func;
+			SCHED_Tasks[i].Due    = SCHED_Tick + DelayMs;
+			SCHED_Tasks[i].Period = PeriodMs;
+			SCHED_Tasks[i].Slack  = SlackMs;
+			
+			SCHED_Insert ( i);
+			
+			return i;
+		}
+	}
+	
+	return SCHED_NONE;
+}
+
+
+
+
+// SCHED_Cancel()
+// remove a task. Main level only, a task may cancel itself.
+void  SCHED_Cancel ( u32_t  Task)
+{
+	SCHED_Task_t  *pT;
+	
+	
+	if ( Task >= SCHED_TASKS)
+	{
+		return;
+	}
+	
+	pT = &SCHED_Tasks[Task];
+	
+	if ( pT->State == SCHED_WHEEL)
+	{
+		SCHED_Unlink ( &SCHED_Wheel[pT->Due & ( SCHED_WHEEL_SIZE - 1)], Task);
+	}
+	
+	else if ( pT->State == SCHED_READY)
+	{
+		SCHED_Unlink ( &SCHED_Ready, Task);
+	}
+	
+	pT->State = SCHED_FREE;
+}
+
+
+
+
+// SCHED_Run()
+// called from the main loop, Idle when it found the Rx queues empty.
+// Moves the tasks of the passed ticks to the ready list and runs one
+// ready task: the first one when idle, else the first one which waited
+// for its slack.
+void  SCHED_Run ( u32_t  Idle)
+{
+	SCHED_Task_t  *pT;
+	u32_t  now, t;
+	u8_t  *pHead;
+	
+	
+	now = SCHED_Tick;
+	
+	while ( SCHED_Done != now)
+	{
+		SCHED_Done++;
+		
+		pHead = &SCHED_Wheel[SCHED_Done & ( SCHED_WHEEL_SIZE - 1)];
+		
+		while ( *pHead != SCHED_NONE)
+		{
+			t = *pHead;
+			
+			if ( SCHED_Tasks[t].Due == SCHED_Done)
+			{
+				*pHead = SCHED_Tasks[t].Next;
+				SCHED_Append ( t);
+			}
+			
+			else
+			{
+				pHead = &SCHED_Tasks[t].Next;
+			}
+		}
+	}
+	
+	pHead = &SCHED_Ready;
+	
+	while ( *pHead != SCHED_NONE)
+	{
+		pT = &SCHED_Tasks[*pHead];
+		
+		if ( Idle  ||  now - pT->Due >= pT->Slack)
+		{
+			break;
+		}
+		
+		pHead = &pT->Next;
+	}
+	
+	if ( *pHead == SCHED_NONE)
+	{
+		return;
+	}
+	
+	t      = *pHead;
+	*pHead = pT->Next;
+	
+	// reschedule before the call, the task may cancel itself
+	if ( pT->Period)
+	{
+		pT->Due += pT->Period;
+		
+		// missed periods are skipped
+		if ( ( s32_t) ( pT->Due - now) <= 0)
+		{
+			pT->Due = now + 1;
+		}
+		
+		SCHED_Insert ( t);
+	}
+	
+	else
+	{
+		pT->State = SCHED_FREE;
+	}
+	
+	SCHED_RUN_HOOK();
+	pT->Func();
+}
+
+
+
+
+// SCHED_Init()
+// empty task list, start Timer0 with a match interrupt every tick
+void  SCHED_Init ( void)
+{
+	u32_t  i;
+	
+	
+	for ( i = 0; i < SCHED_WHEEL_SIZE; i++)
+	{
+		SCHED_Wheel[i] = SCHED_NONE;
+	}
+	
+	SCHED_Ready = SCHED_NONE;
+	SCHED_Tick  = 0;
+	SCHED_Done  = 0;
+	
+	T0TCR = 2;												// stop and reset
+	T0PR  = 0;
+	T0MR0 = TIMER_PCLK / 1000000 * SCHED_TICK_US - 1;
+	T0MCR = 3;												// interrupt and reset on MR0
+	T0IR  = 0xFF;
+	
+	VICVectAddr5 = ( u32_t) SCHED_Isr;
+	VICVectCntl5 = 1 << 5 | SCHED_INTSOURCE;
+	VICIntEnable = 1 << SCHED_INTSOURCE;
+	
+	T0TCR = 1;												// run
+}
@@ -0,0 +1,52 @@
+
+#ifndef  _SCHED_H_
+#define  _SCHED_H_
+
+
+// Cooperative scheduler for the work besides forwarding. Timer0 counts
+// SCHED_Tick in milliseconds on interrupt level, the tasks run from the
+// main loop in SCHED_Run(). A task which is due waits while the main
+// loop has messages to forward, at most for its slack. Tasks must be
+// short, a long job has to be split over several calls.
+
+
+// defines
+#define  SCHED_TICK_US			1000				// Timer0 period
+
+// task slots
+#ifndef  SCHED_TASKS
+#define  SCHED_TASKS				10
+#endif
+
+// timer wheel slots, a power of two. Tasks due later than this share
+// slots and are skipped until their round comes.
+#ifndef  SCHED_WHEEL_SIZE
+#define  SCHED_WHEEL_SIZE		32
+#endif
+
+#define  SCHED_NONE				0xFF				// no task, see SCHED_Add()
+
+
+// task function
+typedef void  ( *SCHED_Func_t) ( void);
+
+
+// time in ticks, counted by the Timer0 interrupt
+extern volatile u32_t  SCHED_Tick;
+
+
+// scheduler function protos
+
+void  SCHED_Init ( void);
+
+
+u32_t  SCHED_Add ( SCHED_Func_t  Func, u32_t  DelayMs, u32_t  PeriodMs, u32_t  SlackMs);
+
+
+void  SCHED_Cancel ( u32_t  Task);
+
+
+void  SCHED_Run ( u32_t  Idle);
+
+
+#endif
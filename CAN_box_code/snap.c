@@ -0,0 +1,120 @@
+
+#include "datatypes.h"
+#include "lpc21xx.h"
+#include "can.h"
+#include "can_user.h"
+#include "snap.h"
+
+
+volatile u32_t  SNAP_Lost;
+
+
+#if SNAP_SLOTS
+
+SNAP_Slot_t  SNAP_Slots[SNAP_SLOTS];
+
+
+
+// SNAP_Update()
+// store a received message. Called once per message, where LOAD_Count()
+// counts it, with CAN_UserLock() held or on interrupt level.
+RAMFUNC void  SNAP_Update ( CANHandle_t  hBus, CANRxMsg_t  *pMsg)
+{
+	SNAP_Slot_t  *pS;
+	u32_t  key, i, n;
+	
+	
+	if ( pMsg->Type & CAN_MSG_RTR)
+	{
+		return;
+	}
+	
+	key = SNAP_KEY ( hBus, pMsg->Id, pMsg->Type);
+	i   = SNAP_Hash ( key);
+	
+	for ( n = 0; n < SNAP_PROBES; n++)
+	{
+		pS = &SNAP_Slots[i];
+		
+		if ( pS->Key == SNAP_KEY_FREE)
+		{
+			// first message of the Id
+			pS->Key  = key;
+			pS->Info = 0;
+		}
+		
+		if ( pS->Key == key)
+		{
+			pS->Data32[0] = pMsg->Data32[0];
+			pS->Data32[1] = pMsg->Data32[1];
+			pS->Seen      = pMsg->TimeStamp32;
+			pS->Info      = ( pMsg->Len & 15) << 24 | ( ( pS->Info + 1) & 0xFFFFFF);
+			
+			return;
+		}
+		
+		i = ( i + 1) & ( SNAP_SLOTS - 1);
+	}
+	
+	SNAP_Lost++;
+}
+
+
+
+
+// SNAP_Find()
+// slot of an Id or NULL when it wasn't seen. Slots are never freed, so
+// the slot stays valid, its content must be read with CAN_UserLock().
+SNAP_Slot_t*  SNAP_Find ( CANHandle_t  hBus, u32_t  Id, u32_t  Type)
+{
+	SNAP_Slot_t  *pS;
+	u32_t  key, i, n;
+	
+	
+	key = SNAP_KEY ( hBus, Id & 0x1FFFFFFF, Type);
+	i   = SNAP_Hash ( key);
+	
+	for ( n = 0; n < SNAP_PROBES; n++)
+	{
+		pS = &SNAP_Slots[i];
+		
+		if ( pS->Key == key)
+		{
+			return pS;
+		}
+		
+		if ( pS->Key == SNAP_KEY_FREE)
+		{
+			break;
+		}
+		
+		i = ( i + 1) & ( SNAP_SLOTS - 1);
+	}
+	
+	return NULL;
+}
+
+
+
+
+// SNAP_Used()
+// slots in use
+u32_t  SNAP_Used ( void)
+{
+	u32_t  i, used;
+	
+	
+	used = 0;
+	
+	for ( i = 0; i < SNAP_SLOTS; i++)
+	{
+		if ( SNAP_Slots[i].Key != SNAP_KEY_FREE)
+		{
+			used++;
+		}
+	}
+	
+	return used;
+}
+
+#endif
@@ -0,0 +1,90 @@
+
+#ifndef  _SNAP_H_
+#define  _SNAP_H_
+
+
+// Last value store. Every data frame received leaves its data, length,
+// Rx timestamp and a receive count in a slot for its bus and Id, so the
+// current state of both busses can be read with DIAG_SVC_SNAP. The
+// slots are an open addressing hash with linear probing: an update is a
+// multiply, a shift and a compare for most Ids. A slot is taken by the
+// first message of an Id and never given back, an Id which finds no
+// slot within SNAP_PROBES is counted in SNAP_Lost. Remote frames carry
+// no data and are not stored.
+
+
+// slots, a power of two of 20 bytes each, 0 builds without the store.
+// Keep a quarter of them free, the probe sequences grow fast on a full
+// table. The 5 KB of the default don't fit beside the RAM code of
+// FASTRUN=1 and the ISO-TP pool, that build has no store. make ramsize
+// shows what is left for one.
+#ifndef  SNAP_SLOTS
+#if FASTRUN
+#define  SNAP_SLOTS				0
+#else
+#define  SNAP_SLOTS				256
+#endif
+#endif
+
+// slots looked at for an Id
+#ifndef  SNAP_PROBES
+#define  SNAP_PROBES				8
+#endif
+
+
+// key of a slot, Id with the type and bus above it. Bit 31 marks a
+// used slot, a cleared one is free.
+#define  SNAP_KEY(hBus, Id, Type)		( 0x80000000 | ( hBus) << 30 | ( ( Type) & CAN_MSG_EXTENDED) << 28 | ( Id))
+#define  SNAP_KEY_FREE			0
+
+// Info of a slot
+#define  SNAP_LEN(Info)			( ( Info) >> 24)
+#define  SNAP_COUNT(Info)		( ( Info) & 0xFFFFFF)			// wraps
+
+
+// A slot. The receive count shares a word with the length, so a message
+// is stored in four words.
+typedef struct {
+
+	u32_t			Key;							// see SNAP_KEY()
+	u32_t			Data32[2];					// data of the last message
+	u32_t			Seen;							// Rx timestamp of the last message
+	u32_t			Info;							// length << 24 | receive count
+} SNAP_Slot_t;
+
+
+#if SNAP_SLOTS
+extern SNAP_Slot_t  SNAP_Slots[SNAP_SLOTS];
+#endif
+
+// Ids without a slot
+extern volatile u32_t  SNAP_Lost;
+
+
+
+// SNAP_Hash()
+// first slot of a key, the upper bits of a multiplicative hash
+static inline u32_t  SNAP_Hash ( u32_t  Key)
+{
+	return ( Key * 0x9E3779B1) >> 16 & ( SNAP_SLOTS - 1);
+}
+
+
+// snap function protos
+
+#if SNAP_SLOTS
+RAMFUNC void  SNAP_Update ( CANHandle_t  hBus, CANRxMsg_t  *pMsg);
+
+
+SNAP_Slot_t*  SNAP_Find ( CANHandle_t  hBus, u32_t  Id, u32_t  Type);
+
+
+u32_t  SNAP_Used ( void);
+#else
+#define  SNAP_Update(hBus, pMsg)
+#define  SNAP_Find(hBus, Id, Type)	( ( SNAP_Slot_t *) NULL)
+#define  SNAP_Used()						0
+#endif
+
+
+#endif
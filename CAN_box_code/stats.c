@@ -0,0 +1,123 @@
+
+#include "datatypes.h"
+#include "lpc21xx.h"
+#include "can.h"
+#include "can_user.h"
+#include "stats.h"
+
+
+// Histograms, sampled on the hot path and read by diag.c
+STAT_Hist_t  STAT_Hist[STAT_HIST_COUNT];
+
+
+// Counters per bus, written by can_user.c, router.c and STAT_Poll()
+volatile STAT_Bus_t  STAT_Bus[2];
+
+
+#define  CAN_ERR_PASSIVE		128					// error counter of error passive state
+
+
+// Error state seen by the last STAT_Poll(), STAT_ERR_... bits
+static u8_t  STAT_ErrState[2];
+
+
+
+// STAT_ErrPoll()
+// count the error passive and bus off edges of one bus
+static void  STAT_ErrPoll ( CANHandle_t  hBus, u32_t  gsr)
+{
+	u32_t  state;
+	
+	
+	state = 0;
+	
+	if ( ( gsr & CAN_GSR_ES)  &&
+			( CAN_GSR_RXERR ( gsr) >= CAN_ERR_PASSIVE  ||  CAN_GSR_TXERR ( gsr) >= CAN_ERR_PASSIVE))
+	{
+		state |= STAT_ERR_PASSIVE;
+	}
+	
+	if ( gsr & CAN_GSR_BS)
+	{
+		state |= STAT_ERR_BUSOFF;
+	}
+	
+	if ( ( state & ~STAT_ErrState[hBus]) & STAT_ERR_PASSIVE)
+	{
+		STAT_Bus[hBus].ErrPassive++;
+	}
+	
+	if ( ( state & ~STAT_ErrState[hBus]) & STAT_ERR_BUSOFF)
+	{
+		STAT_Bus[hBus].BusOff++;
+	}
+	
+	STAT_ErrState[hBus] = state;
+}
+
+
+
+
+// STAT_Poll()
+// scheduled every tick. Polls the error state of both busses, a
+// bus off lasts at least 128 * 11 bit times and is never missed.
+void  STAT_Poll ( void)
+{
+	STAT_ErrPoll ( CAN_BUS1, C1GSR);
+	STAT_ErrPoll ( CAN_BUS2, C2GSR);
+}
+
+
+
+
+// STAT_GetErrState()
+// error state of a bus as seen by the last STAT_Poll()
+u32_t  STAT_GetErrState ( CANHandle_t  hBus)
+{
+	return STAT_ErrState[hBus];
+}
+
+
+
+
+// STAT_Clear()
+// clear histograms, high water marks and the event counters. The Rx
+// counter is left alone, can_user.c derives the Rx queue depth from it.
+void  STAT_Clear ( void)
+{
+	u32_t  i, b;
+	
+	
+	for ( i = 0; i < STAT_HIST_COUNT; i++)
+	{
+		for ( b = 0; b < STAT_BUCKETS; b++)
+		{
+			STAT_Hist[i].Bucket[b] = 0;
+		}
+	}
+	
+	for ( i = 0; i < 2; i++)
+	{
+		STAT_Bus[i].Forwarded  = 0;
+		STAT_Bus[i].Filtered   = 0;
+		STAT_Bus[i].Local      = 0;
+		STAT_Bus[i].RxLost     = 0;
+		STAT_Bus[i].TxRetry    = 0;
+		STAT_Bus[i].TxDrop     = 0;
+		STAT_Bus[i].ErrPassive = 0;
+		STAT_Bus[i].BusOff     = 0;
+		STAT_Bus[i].RxHwm      = 0;
+		STAT_Bus[i].TxHwm      = 0;
+		STAT_Bus[i].Limited    = 0;
+		STAT_Bus[i].Unchanged  = 0;
+		STAT_Bus[i].Purged     = 0;
+		STAT_Bus[i].OffMs      = 0;
+		STAT_Bus[i].OffMaxMs   = 0;
+		STAT_Bus[i].Expired    = 0;
+		STAT_Bus[i].IsoTpSent    = 0;
+		STAT_Bus[i].IsoTpAborted = 0;
+		STAT_Bus[i].J1939Sent    = 0;
+		STAT_Bus[i].J1939Aborted = 0;
+		STAT_Bus[i].RtrAnswered  = 0;
+	}
+}
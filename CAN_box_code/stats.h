@@ -0,0 +1,125 @@
+
+#ifndef  _STATS_H_
+#define  _STATS_H_
+
+
+// defines
+#define  STAT_BUCKETS			16			// bucket n counts values with n significant bits
+
+
+// histograms
+#define  STAT_HIST_LAT_CAN1	0			// forwarding latency to CAN1 in us
+#define  STAT_HIST_LAT_CAN2	1			// forwarding latency to CAN2 in us
+#define  STAT_HIST_LOOP			2			// main loop iteration in us
+#define  STAT_HIST_RXQ_CAN1	3			// Rx queue depth of CAN1
+#define  STAT_HIST_RXQ_CAN2	4			// Rx queue depth of CAN2
+#define  STAT_HIST_TXQ_CAN1	5			// Tx queue depth of CAN1
+#define  STAT_HIST_TXQ_CAN2	6			// Tx queue depth of CAN2
+#define  STAT_HIST_COUNT		7
+
+
+// Log2 histogram. Bucket 0 counts zeros, bucket n the values from
+// 2^(n-1) to 2^n - 1, the last bucket everything above.
+typedef struct {
+
+	u32_t			Bucket[STAT_BUCKETS];
+} STAT_Hist_t;
+
+
+// Traffic and drop counters of a bus. All fields are u32_t, diag.c
+// exports them by index in this order. Counters which the Rx interrupt
+// writes as well are changed on main() level only with CAN_UserLock()
+// held, Rx is written by the timestamp handlers alone.
+typedef struct {
+
+	u32_t			Rx;							// messages received
+	u32_t			Forwarded;					// received and sent to the other bus
+	u32_t			Filtered;					// received and dropped by a rule
+	u32_t			Local;						// received and taken by the router
+	u32_t			RxLost;						// lost on a full Rx queue
+	u32_t			TxRetry;						// forwarding delayed by the full Tx queue
+	u32_t			TxDrop;						// messages dropped on the full Tx queue
+	u32_t			ErrPassive;					// error passive events
+	u32_t			BusOff;						// bus off events
+	u32_t			RxHwm;						// Rx queue high water mark
+	u32_t			TxHwm;						// Tx queue high water mark
+	u32_t			Limited;						// received and dropped by a rate limit
+	u32_t			Unchanged;					// received and dropped with unchanged data
+	u32_t			Purged;						// staged messages dropped on a bus off
+	u32_t			OffMs;						// time spent bus off
+	u32_t			OffMaxMs;					// longest bus off, until the bus was usable again
+	u32_t			Expired;						// staged messages dropped at their deadline
+	u32_t			IsoTpSent;					// ISO-TP messages relayed to this bus
+	u32_t			IsoTpAborted;				// ISO-TP messages for this bus refused or aborted
+	u32_t			J1939Sent;					// J1939 multi-packet messages relayed to this bus
+	u32_t			J1939Aborted;				// J1939 multi-packet messages for this bus refused or aborted
+	u32_t			RtrAnswered;				// remote frames received and answered from an RTR slot
+} STAT_Bus_t;
+
+#define  STAT_CNT_COUNT		( sizeof ( STAT_Bus_t) / sizeof ( u32_t))
+
+
+// error state bits, see STAT_GetErrState()
+#define  STAT_ERR_PASSIVE		1
+#define  STAT_ERR_BUSOFF		2
+
+
+extern STAT_Hist_t  STAT_Hist[STAT_HIST_COUNT];
+extern volatile STAT_Bus_t  STAT_Bus[2];
+
+
+
+// STAT_Sample()
+// add a value to a histogram. A handful of compares and shifts, the
+// ARM7TDMI has no CLZ instruction.
+static inline void  STAT_Sample ( u32_t  Hist, u32_t  Value)
+{
+	u32_t  b;
+	
+	
+	if ( Value >= 1 << ( STAT_BUCKETS - 2))
+	{
+		b = STAT_BUCKETS - 1;
+	}
+	
+	else
+	{
+		b = 0;
+		
+		if ( Value >= 1 << 8)	{ Value >>= 8;	b  = 8; }
+		if ( Value >= 1 << 4)	{ Value >>= 4;	b += 4; }
+		if ( Value >= 1 << 2)	{ Value >>= 2;	b += 2; }
+		if ( Value >= 1 << 1)	{ Value >>= 1;	b += 1; }
+		
+		b += Value;
+	}
+	
+	STAT_Hist[Hist].Bucket[b]++;
+}
+
+
+
+
+// STAT_Hwm()
+// raise a high water mark
+static inline void  STAT_Hwm ( volatile u32_t  *pHwm, u32_t  Value)
+{
+	if ( Value > *pHwm)
+	{
+		*pHwm = Value;
+	}
+}
+
+
+// stats function protos
+
+void  STAT_Poll ( void);
+
+
+void  STAT_Clear ( void);
+
+
+u32_t  STAT_GetErrState ( CANHandle_t  hBus);
+
+
+#endif
@@ -0,0 +1,17 @@
+
+#include "datatypes.h"
+#include "lpc21xx.h"
+#include "timer.h"
+
+
+
+// TIMER_Init()
+// start Timer1 as free running microsecond counter
+void  TIMER_Init ( void)
+{
+	T1TCR = 2;												// stop and reset
+	T1PR  = TIMER_PCLK / 1000000 - 1;				// 1 us per tick
+	T1MCR = 0;												// no match actions
+	T1IR  = 0xFF;
+	T1TCR = 1;												// run
+}
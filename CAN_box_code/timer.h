@@ -0,0 +1,21 @@
+
+#ifndef  _TIMER_H_
+#define  _TIMER_H_
+
+
+// defines
+#define  TIMER_PCLK		60000000			// VPB clock, see crt0.S
+
+
+// Timer1 runs free at 1 MHz. It is the time base for Rx timestamps and
+// latency measurements and wraps after 71 minutes, so always compare
+// unsigned differences. Users need lpc21xx.h.
+#define  TIMER_GetUs()	( ( u32_t) T1TC)
+
+
+// timer function protos
+
+void  TIMER_Init ( void);
+
+
+#endif